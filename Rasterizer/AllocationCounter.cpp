@@ -0,0 +1,120 @@
+#include "AllocationCounter.h"
+
+#ifdef SOFTWARE_COUNT_ALLOCATIONS
+
+// - Standard includes -
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> g_HeapAllocationCount{0};
+
+    /// @brief count and allocate, nullptr when out of memory
+    void* CountedAllocate(std::size_t size) noexcept
+    {
+        g_HeapAllocationCount.fetch_add(1 , std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    /// @brief count and allocate with an alignment above the default one, nullptr when out of memory
+    void* CountedAllocate(std::size_t size , std::align_val_t alignment) noexcept
+    {
+        g_HeapAllocationCount.fetch_add(1 , std::memory_order_relaxed);
+        const std::size_t alignmentBytes = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+        return _aligned_malloc(size == 0 ? 1 : size , alignmentBytes);
+#else
+        //aligned_alloc wants the size as a multiple of the alignment
+        const std::size_t alignedSize = (size + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+        return std::aligned_alloc(alignmentBytes , alignedSize == 0 ? alignmentBytes : alignedSize);
+#endif
+    }
+
+    void AlignedFree(void* pMemory) noexcept
+    {
+#ifdef _MSC_VER
+        _aligned_free(pMemory);
+#else
+        std::free(pMemory);
+#endif
+    }
+}
+
+// ---- Replaced global allocation functions ----
+
+void* operator new(std::size_t size)
+{
+    void* pMemory = CountedAllocate(size);
+    if(!pMemory) throw std::bad_alloc{};
+    return pMemory;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* pMemory = CountedAllocate(size);
+    if(!pMemory) throw std::bad_alloc{};
+    return pMemory;
+}
+
+void* operator new(std::size_t size , const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size , const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size , std::align_val_t alignment)
+{
+    void* pMemory = CountedAllocate(size , alignment);
+    if(!pMemory) throw std::bad_alloc{};
+    return pMemory;
+}
+
+void* operator new[](std::size_t size , std::align_val_t alignment)
+{
+    void* pMemory = CountedAllocate(size , alignment);
+    if(!pMemory) throw std::bad_alloc{};
+    return pMemory;
+}
+
+void* operator new(std::size_t size , std::align_val_t alignment , const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size , alignment);
+}
+
+void* operator new[](std::size_t size , std::align_val_t alignment , const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size , alignment);
+}
+
+void operator delete(void* pMemory) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory , std::size_t) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory , std::size_t) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory , const std::nothrow_t&) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory , const std::nothrow_t&) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory , std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory , std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory , std::size_t , std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory , std::size_t , std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory , std::align_val_t , const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory , std::align_val_t , const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
+
+uint64_t software::GetHeapAllocationCount() noexcept
+{
+    return g_HeapAllocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+uint64_t software::GetHeapAllocationCount() noexcept
+{
+    return 0;
+}
+
+#endif
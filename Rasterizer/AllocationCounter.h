@@ -0,0 +1,25 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+
+//define in a debug or test build to count every heap allocation of the process
+//replaces the global operator new and delete, so it sees the allocations hidden in the standard containers and wrappers
+//#define SOFTWARE_COUNT_ALLOCATIONS
+
+namespace software
+{
+    /// @brief the heap allocations of the whole process so far, on any thread
+    /// @return 0 when SOFTWARE_COUNT_ALLOCATIONS is not defined
+    uint64_t GetHeapAllocationCount() noexcept;
+
+    /// @brief if the heap allocations get counted in this build
+    constexpr bool IsHeapAllocationCounted() noexcept
+    {
+#ifdef SOFTWARE_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+}
@@ -64,6 +64,18 @@ void Camera::SwitchRenderMode()
     CalculateViewMatrix();
 }
 
+/// @brief place the camera directly, used by scripted camera paths instead of the keyboard and mouse input
+/// @param position the new position
+/// @param forward the new forward vector, gets normalized
+void Camera::SetPose(const Elite::FPoint3& position , const Elite::FVector3& forward)
+{
+    m_Position = position;
+    m_ForwardVector = Elite::FVector4{GetNormalized(forward) , m_ForwardVector.w};
+
+    RotationUpdate();
+    ONBMovementUpdate();
+}
+
 /// @brief Called at initialize to init the pojection matrix and 
 /// @brief gets adapted according to the start render mode (software or hardware rasterizer)
 void Camera::CalculateProjectionMatrix()
@@ -0,0 +1,167 @@
+#include "ColorResolve.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace software
+{
+    /// @brief fill the lookup table of the resolve, only needed when the gamma changes
+    /// @param gamma the gamma value of the display, the channels get raised to 1 / gamma
+    /// @param table output
+    void BuildColorResolveTable(float gamma , ColorResolveTable& table)
+    {
+        table.gamma = gamma;
+        for(uint32_t i = 0; i < ColorResolveTableSize; ++i)
+        {
+            const float linear = static_cast<float>(i) / static_cast<float>(ColorResolveTableSize - 1);
+            table.values[i] = static_cast<uint8_t>(std::pow(linear , 1.0f / gamma) * 255.0f + 0.5f);
+        }
+    }
+
+    /// @brief clamp a channel of 4 pixels to [0, 1] and quantize it to the steps of the gamma table
+    /// @param channel the linear channel of 4 pixels
+    /// @return the table index of every pixel, in 32 bit lanes
+    static __m128i GetColorResolveSteps(__m128 channel) noexcept
+    {
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(channel , _mm_setzero_ps()) , _mm_set1_ps(1.0f));
+        return _mm_cvtps_epi32(_mm_mul_ps(clamped , _mm_set1_ps(static_cast<float>(ColorResolveTableSize - 1))));
+    }
+
+    /// @brief convert a row of the linear rgba float color buffer to 32 bit pixels of the target surface
+    /// @brief 4 pixels per iteration, transposed to a register per channel, clamped, quantized and shifted into place 4 at a time
+    /// @brief the gamma curve stays a table lookup with the indices taken from the registers, sse2 has no gather
+    /// @param pColors 4 floats per pixel, red green blue and an unused alpha
+    /// @param pPixels output, the row of the surface
+    /// @param count amount of pixels
+    /// @param table the gamma lookup table
+    /// @param layout the channel positions of the surface format
+    void ResolveColorRow(const float* pColors , uint32_t* pPixels , uint32_t count , const ColorResolveTable& table
+        , const PixelLayout& layout) noexcept
+    {
+        const uint8_t* const pTable = table.values;
+        const __m128i redShift = _mm_cvtsi32_si128(static_cast<int>(layout.redShift));
+        const __m128i greenShift = _mm_cvtsi32_si128(static_cast<int>(layout.greenShift));
+        const __m128i blueShift = _mm_cvtsi32_si128(static_cast<int>(layout.blueShift));
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(layout.alphaMask));
+
+        uint32_t i = 0;
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128 red = _mm_loadu_ps(pColors + size_t(i) * 4);
+            __m128 green = _mm_loadu_ps(pColors + size_t(i) * 4 + 4);
+            __m128 blue = _mm_loadu_ps(pColors + size_t(i) * 4 + 8);
+            __m128 unused = _mm_loadu_ps(pColors + size_t(i) * 4 + 12);
+            _MM_TRANSPOSE4_PS(red , green , blue , unused);
+
+            //the steps are below 4096, packed to 16 bit lanes every index comes straight out of a register
+            const __m128i redGreenSteps = _mm_packs_epi32(GetColorResolveSteps(red) , GetColorResolveSteps(green));
+            const __m128i blueSteps = _mm_packs_epi32(GetColorResolveSteps(blue) , _mm_setzero_si128());
+
+            const __m128i redValues = _mm_setr_epi32(pTable[_mm_extract_epi16(redGreenSteps , 0)] , pTable[_mm_extract_epi16(redGreenSteps , 1)]
+                , pTable[_mm_extract_epi16(redGreenSteps , 2)] , pTable[_mm_extract_epi16(redGreenSteps , 3)]);
+            const __m128i greenValues = _mm_setr_epi32(pTable[_mm_extract_epi16(redGreenSteps , 4)] , pTable[_mm_extract_epi16(redGreenSteps , 5)]
+                , pTable[_mm_extract_epi16(redGreenSteps , 6)] , pTable[_mm_extract_epi16(redGreenSteps , 7)]);
+            const __m128i blueValues = _mm_setr_epi32(pTable[_mm_extract_epi16(blueSteps , 0)] , pTable[_mm_extract_epi16(blueSteps , 1)]
+                , pTable[_mm_extract_epi16(blueSteps , 2)] , pTable[_mm_extract_epi16(blueSteps , 3)]);
+
+            //every channel shifted to its place in the surface format, any channel order with the same instructions
+            const __m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(redValues , redShift) , _mm_sll_epi32(greenValues , greenShift))
+                , _mm_or_si128(_mm_sll_epi32(blueValues , blueShift) , alpha));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pPixels + i) , pixels);
+        }
+
+        //the last pixels of a row that isn't a multiple of 4, one at a time
+        alignas(16) int32_t steps[4];
+        for(; i < count; ++i)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(steps) , GetColorResolveSteps(_mm_loadu_ps(pColors + size_t(i) * 4)));
+
+            pPixels[i] = (uint32_t(pTable[steps[0]]) << layout.redShift) | (uint32_t(pTable[steps[1]]) << layout.greenShift)
+                | (uint32_t(pTable[steps[2]]) << layout.blueShift) | layout.alphaMask;
+        }
+    }
+
+    /// @brief get the sample position of a target pixel in the source image, pixel centers lined up and clamped to the edges
+    /// @param sourceSize the width or height of the source
+    /// @param targetSize the width or height of the target
+    /// @param target the column or row of the target
+    /// @param sourceIndex output, the first pixel of the pair
+    /// @param weight output, of the second pixel of the pair, 0 to 256
+    static void GetUpscaleSample(uint32_t sourceSize , uint32_t targetSize , uint32_t target , uint32_t& sourceIndex , uint32_t& weight) noexcept
+    {
+        const float position = std::max((static_cast<float>(target) + 0.5f) * static_cast<float>(sourceSize) / static_cast<float>(targetSize) - 0.5f , 0.0f);
+        sourceIndex = std::min(static_cast<uint32_t>(position) , sourceSize - 1);
+        weight = static_cast<uint32_t>((position - static_cast<float>(sourceIndex)) * 256.0f + 0.5f);
+    }
+
+    /// @brief calculate the sample pairs of every column of an upscale, once per frame
+    /// @param sourceWidth the width of the source image, at least 1
+    /// @param pColumns output, one per column of the target
+    /// @param count the width of the target
+    void BuildUpscaleColumns(uint32_t sourceWidth , UpscaleColumn* pColumns , uint32_t count) noexcept
+    {
+        for(uint32_t x = 0; x < count; ++x)
+        {
+            uint32_t sourceX , weight;
+            GetUpscaleSample(sourceWidth , count , x , sourceX , weight);
+
+            //the pair gets loaded as one, the last column takes all of the right pixel of the pair before it
+            if(sourceX + 1 >= sourceWidth)
+            {
+                sourceX = (sourceWidth > 1) ? sourceWidth - 2 : 0;
+                weight = (sourceWidth > 1) ? 256 : 0;
+            }
+            pColumns[x] = UpscaleColumn{sourceX , weight};
+        }
+    }
+
+    /// @brief get the sample rows of a row of an upscale
+    /// @param sourceHeight the height of the source image, at least 1
+    /// @param targetHeight the height of the target
+    /// @param y the row of the target
+    UpscaleRow GetUpscaleRow(uint32_t sourceHeight , uint32_t targetHeight , uint32_t y) noexcept
+    {
+        UpscaleRow row{};
+        GetUpscaleSample(sourceHeight , targetHeight , y , row.sourceY , row.weight);
+        row.sourceYBelow = std::min(row.sourceY + 1 , sourceHeight - 1);
+        return row;
+    }
+
+    /// @brief bilinear upscale of a row of 32 bit pixels, the 4 channels of a pixel in 16 bit lanes of one register
+    /// @param pSourceRow the top source row
+    /// @param pSourceRowBelow the bottom source row
+    /// @param rowWeight the weight of the bottom row, 0 to 256
+    /// @param pColumns the sample pairs of the columns, from BuildUpscaleColumns
+    /// @param pPixels output, the row of the target
+    /// @param count the width of the target
+    void UpscaleRowBilinear(const uint32_t* pSourceRow , const uint32_t* pSourceRowBelow , uint32_t rowWeight
+        , const UpscaleColumn* pColumns , uint32_t* pPixels , uint32_t count) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i topWeight = _mm_set1_epi16(static_cast<short>(256 - rowWeight));
+        const __m128i bottomWeight = _mm_set1_epi16(static_cast<short>(rowWeight));
+
+        for(uint32_t x = 0; x < count; ++x)
+        {
+            const UpscaleColumn& column = pColumns[x];
+
+            //the left and right pixel of both rows, 8 channels of 16 bit each
+            const __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSourceRow + column.sourceX)) , zero);
+            const __m128i bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSourceRowBelow + column.sourceX)) , zero);
+
+            //at most 255 * 256, fits the unsigned 16 bit lanes
+            const __m128i vertical = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top , topWeight) , _mm_mullo_epi16(bottom , bottomWeight)) , 8);
+
+            const __m128i columnWeights = _mm_set_epi16(
+                static_cast<short>(column.weight) , static_cast<short>(column.weight) , static_cast<short>(column.weight) , static_cast<short>(column.weight)
+                , static_cast<short>(256 - column.weight) , static_cast<short>(256 - column.weight) , static_cast<short>(256 - column.weight)
+                , static_cast<short>(256 - column.weight));
+            const __m128i weighted = _mm_mullo_epi16(vertical , columnWeights);
+            const __m128i horizontal = _mm_srli_epi16(_mm_add_epi16(weighted , _mm_srli_si128(weighted , 8)) , 8);
+
+            pPixels[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(horizontal , zero)));
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+
+namespace software
+{
+    /// @brief amount of steps a color channel is quantized to before the gamma lookup, finer than 8 bit so dark gradients keep their steps
+    constexpr uint32_t ColorResolveTableSize{4096};
+
+    /// @brief the gamma curve of the resolve as a lookup table from linear channel to 8 bit
+    struct ColorResolveTable
+    {
+        float gamma{-1.0f};
+        uint8_t values[ColorResolveTableSize];
+    };
+
+    /// @brief where the channels go in a 32 bit pixel of the target surface
+    struct PixelLayout
+    {
+        uint32_t redShift;
+        uint32_t greenShift;
+        uint32_t blueShift;
+        uint32_t alphaMask; //written as opaque
+    };
+
+    /// @brief where a column of the upscaled image samples the smaller one, the same for every row
+    struct UpscaleColumn
+    {
+        uint32_t sourceX; //left pixel of the pair, the right one is sourceX + 1
+        uint32_t weight; //of the right pixel, 0 to 256
+    };
+
+    /// @brief the row pair and weight a row of the upscaled image samples
+    struct UpscaleRow
+    {
+        uint32_t sourceY; //top row
+        uint32_t sourceYBelow; //sourceY + 1, or sourceY on the last row
+        uint32_t weight; //of the bottom row, 0 to 256
+    };
+
+    void BuildColorResolveTable(float gamma , ColorResolveTable& table);
+    void ResolveColorRow(const float* pColors , uint32_t* pPixels , uint32_t count , const ColorResolveTable& table
+        , const PixelLayout& layout) noexcept;
+
+    void BuildUpscaleColumns(uint32_t sourceWidth , UpscaleColumn* pColumns , uint32_t count) noexcept;
+    UpscaleRow GetUpscaleRow(uint32_t sourceHeight , uint32_t targetHeight , uint32_t y) noexcept;
+    void UpscaleRowBilinear(const uint32_t* pSourceRow , const uint32_t* pSourceRowBelow , uint32_t rowWeight
+        , const UpscaleColumn* pColumns , uint32_t* pPixels , uint32_t count) noexcept;
+}
@@ -0,0 +1,84 @@
+#include "DrawOrder.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <numeric>
+
+// ---- Functionality ----
+
+/// @brief sort the primitives of this frame, starting from the order of the last one
+/// @param sceneBVH updated for this frame, for the world bounds of the primitives
+/// @param isBlended per primitive, 1 if it gets drawn with blending
+/// @param viewProjectionMatrix projection * view of the camera, its w row gives the view depth
+void DrawOrder::Update(const SceneBVH& sceneBVH , std::span<const uint8_t> isBlended , const Elite::FMatrix4& viewProjectionMatrix)
+{
+    const size_t primitiveCount = isBlended.size();
+
+    //other primitives, the order of the last frame means nothing
+    if(m_Order.size() != primitiveCount)
+    {
+        m_Order.resize(primitiveCount);
+        std::iota(m_Order.begin() , m_Order.end() , 0u);
+        m_IsBlended.clear();
+    }
+
+    //a primitive changed side, the rest keeps its place
+    if(!std::equal(isBlended.begin() , isBlended.end() , m_IsBlended.begin() , m_IsBlended.end()))
+    {
+        m_IsBlended.assign(isBlended.begin() , isBlended.end());
+        const auto blendedStart = std::stable_partition(m_Order.begin() , m_Order.end() , [this](uint32_t primitive) { return !m_IsBlended[primitive]; });
+        m_BlendedStart = static_cast<size_t>(blendedStart - m_Order.begin());
+    }
+
+    //the w of the center of the bounds in clip space is its depth along the view direction
+    m_SortKeys.resize(primitiveCount);
+    for(size_t primitive = 0; primitive < primitiveCount; ++primitive)
+    {
+        const BoundingBoxWorld& bounds = sceneBVH.GetWorldBounds(primitive);
+        const float centerX = (bounds.min.x + bounds.max.x) * 0.5f;
+        const float centerY = (bounds.min.y + bounds.max.y) * 0.5f;
+        const float centerZ = (bounds.min.z + bounds.max.z) * 0.5f;
+        const float viewDepth = viewProjectionMatrix(3 , 0) * centerX + viewProjectionMatrix(3 , 1) * centerY
+            + viewProjectionMatrix(3 , 2) * centerZ + viewProjectionMatrix(3 , 3);
+
+        //both ranges sort ascending, the blended one back to front
+        m_SortKeys[primitive] = m_IsBlended[primitive] ? -viewDepth : viewDepth;
+    }
+
+    m_MoveCount = InsertionSort(0 , m_BlendedStart) + InsertionSort(m_BlendedStart , primitiveCount);
+}
+
+/// @brief forget the order, the next update starts from the submission order
+void DrawOrder::Reset() noexcept
+{
+    m_Order.clear();
+    m_IsBlended.clear();
+    m_BlendedStart = 0;
+    m_MoveCount = 0;
+}
+
+// ---- Private Functions ----
+
+/// @brief stable insertion sort of a range of m_Order on the sort keys, close to linear on the nearly sorted order of the last frame
+/// @param first the first position of the range
+/// @param last one past the last position
+/// @return the places the primitives moved
+size_t DrawOrder::InsertionSort(size_t first , size_t last) noexcept
+{
+    size_t moveCount = 0;
+    for(size_t i = first + 1; i < last; ++i)
+    {
+        const uint32_t primitive = m_Order[i];
+        const float key = m_SortKeys[primitive];
+
+        size_t position = i;
+        while(position > first && m_SortKeys[m_Order[position - 1]] > key)
+        {
+            m_Order[position] = m_Order[position - 1];
+            --position;
+        }
+        m_Order[position] = primitive;
+        moveCount += i - position;
+    }
+    return moveCount;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "SceneBVH.h"
+
+/// @brief The order the primitives of a frame get drawn in, the opaque ones front to back and then the blended ones back to front
+/// @brief Front to back lets the depth test and the hierarchical z reject the most, back to front is what blending needs
+/// @brief The order of the last frame is kept and re-sorted with an insertion sort, linear when few primitives swapped places
+class DrawOrder final
+{
+public:
+
+      // ---- Constructors ----
+    DrawOrder() = default;
+
+    // ---- Destructor ----
+    ~DrawOrder() = default;
+
+    // ---- Copy/Move ----
+    DrawOrder(const DrawOrder& other) = delete; //copy constructor
+    DrawOrder(DrawOrder&& other) noexcept = delete; //move constructor
+    DrawOrder& operator=(const DrawOrder& other) = delete; // copy assignment
+    DrawOrder& operator=(DrawOrder&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void Update(const SceneBVH& sceneBVH , std::span<const uint8_t> isBlended , const Elite::FMatrix4& viewProjectionMatrix);
+    void Reset() noexcept;
+
+    // -- Getters --
+    std::span<const uint32_t> GetOrder() const noexcept;
+    size_t GetMoveCount() const noexcept;
+
+private:
+
+      // ---- Private Functions ----
+    size_t InsertionSort(size_t first , size_t last) noexcept;
+
+    // ---- Data members ----
+    std::vector<uint32_t> m_Order; //primitive indices, the opaque ones first
+    std::vector<float> m_SortKeys; //per primitive, the view depth of its bounds, negated for the blended ones
+    std::vector<uint8_t> m_IsBlended; //per primitive, of the last update, the order gets partitioned again when it changes
+    size_t m_BlendedStart{0}; //first blended primitive in m_Order
+    size_t m_MoveCount{0}; //places the primitives moved in the last update
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// -- Getters --
+inline std::span<const uint32_t> DrawOrder::GetOrder() const noexcept
+{
+    return m_Order;
+}
+
+inline size_t DrawOrder::GetMoveCount() const noexcept
+{
+    return m_MoveCount;
+}
@@ -0,0 +1,55 @@
+#include "DynamicResolution.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cmath>
+
+/// @brief feed the time of the last frame and pick the scale of the next one
+/// @param frameMilliseconds how long the last frame took
+void DynamicResolution::Update(float frameMilliseconds) noexcept
+{
+    if(m_Budget <= 0.0f) return;
+
+    ++m_FrameCount;
+    if(frameMilliseconds > m_Budget) ++m_BudgetMissCount;
+
+    //the first frame starts the average, after that an exponential moving average over the recent frames
+    m_AverageFrameTime = (m_FrameCount == 1) ? frameMilliseconds : m_AverageFrameTime + (frameMilliseconds - m_AverageFrameTime) * Smoothing;
+    if(m_AverageFrameTime <= 0.0f) return;
+
+    //the time goes with the pixel count, the scale squared
+    const float targetScale = std::clamp(m_Scale * std::sqrt(m_Budget * Headroom / m_AverageFrameTime) , m_MinScale , m_MaxScale);
+    if(std::abs(targetScale - m_Scale) < MinScaleStep && targetScale != m_MinScale && targetScale != m_MaxScale) return;
+
+    //halfway per frame, the average lags behind a change of the scale
+    m_Scale += (targetScale - m_Scale) * 0.5f;
+}
+
+/// @brief get the internal size of an axis at the current scale
+/// @param size the full size, the width or height of the window
+/// @return at least 2 pixels, or the full size when it is smaller, the upscale samples pixel pairs
+uint32_t DynamicResolution::GetScaledSize(uint32_t size) const noexcept
+{
+    return std::max(static_cast<uint32_t>(static_cast<float>(size) * m_Scale + 0.5f) , std::min(size , 2u));
+}
+
+/// @brief set the frame time to hold, the scale is reset to the largest one
+/// @param milliseconds the budget, 0 renders at full resolution again
+void DynamicResolution::SetBudget(float milliseconds) noexcept
+{
+    m_Budget = std::max(milliseconds , 0.0f);
+    m_Scale = (m_Budget > 0.0f) ? m_MaxScale : 1.0f;
+    m_AverageFrameTime = 0.0f;
+    m_FrameCount = 0;
+    m_BudgetMissCount = 0;
+}
+
+/// @brief set the range the scale of both axes stays in
+/// @param minScale the smallest scale, for example 0.5 for half the width and height
+/// @param maxScale the largest scale, at most 1
+void DynamicResolution::SetScaleRange(float minScale , float maxScale) noexcept
+{
+    m_MaxScale = std::clamp(maxScale , 0.1f , 1.0f);
+    m_MinScale = std::clamp(minScale , 0.1f , m_MaxScale);
+    if(m_Budget > 0.0f) m_Scale = std::clamp(m_Scale , m_MinScale , m_MaxScale);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+
+/// @brief Controller of the internal resolution of the software renderer, holds the frame time under a budget
+/// @brief The cost of a frame goes with the amount of pixels, so the scale of both axes follows the square root of the time ratio
+/// @brief Without a budget it stays at full resolution
+class DynamicResolution final
+{
+public:
+
+      // ---- Constructors ----
+    DynamicResolution() = default;
+
+    // ---- Destructor ----
+    ~DynamicResolution() = default;
+
+    // ---- Copy/Move ----
+    DynamicResolution(const DynamicResolution& other) = delete; //copy constructor
+    DynamicResolution(DynamicResolution&& other) noexcept = delete; //move constructor
+    DynamicResolution& operator=(const DynamicResolution& other) = delete; // copy assignment
+    DynamicResolution& operator=(DynamicResolution&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void Update(float frameMilliseconds) noexcept;
+    uint32_t GetScaledSize(uint32_t size) const noexcept;
+
+    // -- Setters --
+    void SetBudget(float milliseconds) noexcept;
+    void SetScaleRange(float minScale , float maxScale) noexcept;
+
+    // -- Getters --
+    float GetBudget() const noexcept;
+    float GetScale() const noexcept;
+    float GetAverageFrameTime() const noexcept;
+    uint64_t GetFrameCount() const noexcept;
+    uint64_t GetBudgetMissCount() const noexcept;
+
+private:
+
+    // ---- Data members ----
+    static constexpr float Smoothing{0.2f}; //weight of the newest frame in the average
+    static constexpr float Headroom{0.9f}; //aim under the budget, so a spike doesn't miss it right away
+    static constexpr float MinScaleStep{0.02f}; //smaller changes are ignored, they would only make the image swim
+
+    float m_Budget{0.0f}; //milliseconds, 0 turns the controller off
+    float m_MinScale{0.5f};
+    float m_MaxScale{1.0f};
+    float m_Scale{1.0f};
+    float m_AverageFrameTime{0.0f};
+    uint64_t m_FrameCount{0};
+    uint64_t m_BudgetMissCount{0};
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// -- Getters --
+inline float DynamicResolution::GetBudget() const noexcept
+{
+    return m_Budget;
+}
+
+inline float DynamicResolution::GetScale() const noexcept
+{
+    return m_Scale;
+}
+
+inline float DynamicResolution::GetAverageFrameTime() const noexcept
+{
+    return m_AverageFrameTime;
+}
+
+inline uint64_t DynamicResolution::GetFrameCount() const noexcept
+{
+    return m_FrameCount;
+}
+
+inline uint64_t DynamicResolution::GetBudgetMissCount() const noexcept
+{
+    return m_BudgetMissCount;
+}
@@ -0,0 +1,408 @@
+#include "EdgeFunctions.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//msvc compiles intrinsics of any instruction set, gcc and clang need the target on the function
+#if defined(_MSC_VER)
+#define SOFTWARE_TARGET_AVX2
+#else
+#define SOFTWARE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+    /// @brief index of the lowest set bit, mask can't be 0
+    inline uint32_t CountTrailingZeros(uint32_t mask) noexcept
+    {
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index , mask);
+        return static_cast<uint32_t>(index);
+    #else
+        return static_cast<uint32_t>(__builtin_ctz(mask));
+    #endif
+    }
+
+    /// @brief the first count bits set, count is at most 8
+    inline uint32_t GetLaneMask(int count) noexcept
+    {
+        return (1u << count) - 1u;
+    }
+
+    /// @brief write a fragment for every bit of the mask, lane i belongs to column left + i
+    inline uint32_t EmitFragments(uint32_t mask , int left , const float* pWeights0 , const float* pWeights1
+        , const float* pWeights2 , const float* pDepths , software::RasterFragment* pFragments) noexcept
+    {
+        uint32_t fragmentCount = 0;
+        while(mask)
+        {
+            const uint32_t lane = CountTrailingZeros(mask);
+            mask &= mask - 1;
+            pFragments[fragmentCount++] = software::RasterFragment{static_cast<uint32_t>(left) + lane
+                , pWeights0[lane] , pWeights1[lane] , pWeights2[lane] , pDepths[lane]};
+        }
+        return fragmentCount;
+    }
+
+    /// @brief edge values beyond this have the same sign over a whole span, so they get clamped to fit 32 bit lanes
+    /// @brief a step over a span of TileSize pixels stays far below it, even for triangles reaching into the guard band
+    constexpr int64_t SpanEdgeLimit{int64_t(1) << 30};
+
+    /// @brief the fixed point value of an edge at the start of a span, clamped to 32 bit
+    inline int32_t GetSpanEdgeStart(const software::FixedPointEdge& edge , int left , int row) noexcept
+    {
+        const int64_t value = edge.stepX * left + edge.stepY * row + edge.constant;
+        return static_cast<int32_t>(std::clamp(value , -SpanEdgeLimit , SpanEdgeLimit));
+    }
+
+    /// @brief a raster space coordinate in fixed point, it has to be snapped already
+    inline int64_t ToFixedPoint(float coordinate) noexcept
+    {
+        return static_cast<int64_t>(std::llround(coordinate * static_cast<float>(software::SubPixelSteps)));
+    }
+}
+
+namespace software
+{
+    /// @brief round a raster space coordinate to the sub pixel grid, so the fixed point edges are exact
+    /// @param coordinate x or y in raster space
+    /// @return the nearest multiple of 1 / SubPixelSteps
+    float SnapToSubPixel(float coordinate) noexcept
+    {
+        return std::round(coordinate * static_cast<float>(SubPixelSteps)) / static_cast<float>(SubPixelSteps);
+    }
+
+    /// @brief the exact double area of a triangle with snapped vertices, the same sign convention as the float areaParallelogram
+    /// @return the area in square sub pixels, 0 for a degenerate triangle
+    int64_t GetFixedPointArea(const Elite::FPoint4& vertex0 , const Elite::FPoint4& vertex1 , const Elite::FPoint4& vertex2) noexcept
+    {
+        const int64_t x0 = ToFixedPoint(vertex0.x) , y0 = ToFixedPoint(vertex0.y);
+        return (ToFixedPoint(vertex2.x) - x0) * (ToFixedPoint(vertex1.y) - y0) - (ToFixedPoint(vertex2.y) - y0) * (ToFixedPoint(vertex1.x) - x0);
+    }
+
+    /// @brief set up the fixed point and the prescaled edge equations, once per triangle
+    /// @param vertex0 first vertex in raster space, snapped to the sub pixel grid
+    /// @param vertex1 second vertex in raster space, snapped to the sub pixel grid
+    /// @param vertex2 third vertex in raster space, snapped to the sub pixel grid
+    /// @param areaParallelogram the signed double area of the triangle, can't be 0
+    /// @return the edge equations of the triangle
+    TriangleEdges SetupTriangleEdges(const Elite::FPoint4& vertex0 , const Elite::FPoint4& vertex1 , const Elite::FPoint4& vertex2
+        , float areaParallelogram) noexcept
+    {
+        const float invArea = 1.0f / areaParallelogram;
+
+        //same sign convention as GetWeight(a, b, pixel): edge from a to b
+        //sampled at the pixel center, the weight at (x + 0.5 , y + 0.5)
+        const auto setupEdge = [invArea](float (&edge)[3] , const Elite::FPoint4& a , const Elite::FPoint4& b)
+        {
+            const float edgeA = b.y - a.y;
+            const float edgeB = a.x - b.x;
+            edge[0] = edgeA * invArea;
+            edge[1] = edgeB * invArea;
+            edge[2] = (-(edgeA * a.x + edgeB * a.y) + 0.5f * (edgeA + edgeB)) * invArea;
+        };
+
+        //the same edges in fixed point, flipped for a negative area so the inside is always >= 0
+        const int64_t sign = areaParallelogram > 0.0f ? 1 : -1;
+        const auto setupFixedPointEdge = [sign](FixedPointEdge& edge , const Elite::FPoint4& a , const Elite::FPoint4& b)
+        {
+            const int64_t ax = ToFixedPoint(a.x) , ay = ToFixedPoint(a.y);
+            const int64_t edgeA = sign * (ToFixedPoint(b.y) - ay);
+            const int64_t edgeB = sign * (ax - ToFixedPoint(b.x));
+
+            //top-left rule, y points down: on a left edge the inside is to the right, on a top edge below
+            //a pixel center exactly on any other edge belongs to the neighbouring triangle
+            const bool isTopLeft = edgeA > 0 || (edgeA == 0 && edgeB > 0);
+
+            constexpr int64_t halfPixel = SubPixelSteps / 2;
+            edge.stepX = edgeA * SubPixelSteps;
+            edge.stepY = edgeB * SubPixelSteps;
+            edge.constant = edgeA * (halfPixel - ax) + edgeB * (halfPixel - ay) - (isTopLeft ? 0 : 1);
+        };
+
+        TriangleEdges edges;
+        setupFixedPointEdge(edges.fixedEdges[0] , vertex1 , vertex2);
+        setupFixedPointEdge(edges.fixedEdges[1] , vertex2 , vertex0);
+        setupFixedPointEdge(edges.fixedEdges[2] , vertex0 , vertex1);
+        setupEdge(edges.edge0 , vertex1 , vertex2);
+        setupEdge(edges.edge1 , vertex2 , vertex0);
+        setupEdge(edges.edge2 , vertex0 , vertex1);
+        //not 1 / z, a vertex the clipper made on the near plane has z = 0
+        edges.vertex0Z = vertex0.z;
+        edges.vertex1Z = vertex1.z;
+        edges.vertex2Z = vertex2.z;
+        return edges;
+    }
+
+    /// @brief scalar fallback, one pixel at a time
+    uint32_t RasterizeSpanScalar(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept
+    {
+        const float column = static_cast<float>(left);
+        const float rowBase0 = edges.edge0[0] * column + (edges.edge0[1] * static_cast<float>(row) + edges.edge0[2]);
+        const float rowBase1 = edges.edge1[0] * column + (edges.edge1[1] * static_cast<float>(row) + edges.edge1[2]);
+        const float rowBase2 = edges.edge2[0] * column + (edges.edge2[1] * static_cast<float>(row) + edges.edge2[2]);
+
+        const int32_t fixedRowBase0 = GetSpanEdgeStart(edges.fixedEdges[0] , left , row);
+        const int32_t fixedRowBase1 = GetSpanEdgeStart(edges.fixedEdges[1] , left , row);
+        const int32_t fixedRowBase2 = GetSpanEdgeStart(edges.fixedEdges[2] , left , row);
+        const int32_t fixedStep0 = static_cast<int32_t>(edges.fixedEdges[0].stepX);
+        const int32_t fixedStep1 = static_cast<int32_t>(edges.fixedEdges[1].stepX);
+        const int32_t fixedStep2 = static_cast<int32_t>(edges.fixedEdges[2].stepX);
+
+        uint32_t fragmentCount = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            //check if inside triangle, exact in fixed point
+            if(testCoverage && ((fixedRowBase0 + fixedStep0 * i) | (fixedRowBase1 + fixedStep1 * i) | (fixedRowBase2 + fixedStep2 * i)) < 0) continue;
+
+            const float offset = static_cast<float>(i);
+            const float weight0 = rowBase0 + edges.edge0[0] * offset;
+            const float weight1 = rowBase1 + edges.edge1[0] * offset;
+            const float weight2 = rowBase2 + edges.edge2[0] * offset;
+
+            //ndc depth, linear in screen space
+            const float zBuffer = weight0 * edges.vertex0Z + weight1 * edges.vertex1Z + weight2 * edges.vertex2Z;
+
+            //inside the depth range and closer to the camera
+            if(!(zBuffer <= 1.0f && zBuffer >= 0.0f && zBuffer < pDepthRow[i])) continue;
+
+            pFragments[fragmentCount++] = RasterFragment{static_cast<uint32_t>(left + i) , weight0 , weight1 , weight2 , zBuffer};
+        }
+        return fragmentCount;
+    }
+
+    /// @brief count the pixels of a span inside the triangle, without the depth test, for the pipeline statistics
+    /// @return the amount of covered pixels
+    uint32_t CountSpanCoverage(const TriangleEdges& edges , int left , int row , int count) noexcept
+    {
+        const int32_t fixedRowBase0 = GetSpanEdgeStart(edges.fixedEdges[0] , left , row);
+        const int32_t fixedRowBase1 = GetSpanEdgeStart(edges.fixedEdges[1] , left , row);
+        const int32_t fixedRowBase2 = GetSpanEdgeStart(edges.fixedEdges[2] , left , row);
+        const int32_t fixedStep0 = static_cast<int32_t>(edges.fixedEdges[0].stepX);
+        const int32_t fixedStep1 = static_cast<int32_t>(edges.fixedEdges[1].stepX);
+        const int32_t fixedStep2 = static_cast<int32_t>(edges.fixedEdges[2].stepX);
+
+        uint32_t coveredCount = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            if(((fixedRowBase0 + fixedStep0 * i) | (fixedRowBase1 + fixedStep1 * i) | (fixedRowBase2 + fixedStep2 * i)) >= 0) ++coveredCount;
+        }
+        return coveredCount;
+    }
+
+    /// @brief 4 pixels per instruction, sse2 is part of every x64 cpu
+    uint32_t RasterizeSpanSSE(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept
+    {
+        const float column = static_cast<float>(left);
+        const __m128 rowBase0 = _mm_set1_ps(edges.edge0[0] * column + (edges.edge0[1] * static_cast<float>(row) + edges.edge0[2]));
+        const __m128 rowBase1 = _mm_set1_ps(edges.edge1[0] * column + (edges.edge1[1] * static_cast<float>(row) + edges.edge1[2]));
+        const __m128 rowBase2 = _mm_set1_ps(edges.edge2[0] * column + (edges.edge2[1] * static_cast<float>(row) + edges.edge2[2]));
+        const __m128 step0 = _mm_set1_ps(edges.edge0[0]);
+        const __m128 step1 = _mm_set1_ps(edges.edge1[0]);
+        const __m128 step2 = _mm_set1_ps(edges.edge2[0]);
+        const __m128 z0 = _mm_set1_ps(edges.vertex0Z);
+        const __m128 z1 = _mm_set1_ps(edges.vertex1Z);
+        const __m128 z2 = _mm_set1_ps(edges.vertex2Z);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 allLanes = _mm_cmpeq_ps(zero , zero);
+
+        //the fixed point edges of the first 4 pixels, stepped with integer adds
+        const auto getFixedLanes = [left , row](const FixedPointEdge& edge)
+        {
+            const int32_t start = GetSpanEdgeStart(edge , left , row);
+            const int32_t step = static_cast<int32_t>(edge.stepX);
+            return _mm_setr_epi32(start , start + step , start + step * 2 , start + step * 3);
+        };
+        __m128i fixedEdge0 = getFixedLanes(edges.fixedEdges[0]);
+        __m128i fixedEdge1 = getFixedLanes(edges.fixedEdges[1]);
+        __m128i fixedEdge2 = getFixedLanes(edges.fixedEdges[2]);
+        const __m128i fixedStep0 = _mm_set1_epi32(static_cast<int32_t>(edges.fixedEdges[0].stepX * 4));
+        const __m128i fixedStep1 = _mm_set1_epi32(static_cast<int32_t>(edges.fixedEdges[1].stepX * 4));
+        const __m128i fixedStep2 = _mm_set1_epi32(static_cast<int32_t>(edges.fixedEdges[2].stepX * 4));
+        const __m128i minusOne = _mm_set1_epi32(-1);
+
+        alignas(16) float weights0[4] , weights1[4] , weights2[4] , depths[4] , depthRow[4];
+
+        uint32_t fragmentCount = 0;
+        __m128 offset = _mm_setr_ps(0.0f , 1.0f , 2.0f , 3.0f);
+        for(int i = 0; i < count; i += 4 , offset = _mm_add_ps(offset , _mm_set1_ps(4.0f)) , fixedEdge0 = _mm_add_epi32(fixedEdge0 , fixedStep0)
+            , fixedEdge1 = _mm_add_epi32(fixedEdge1 , fixedStep1) , fixedEdge2 = _mm_add_epi32(fixedEdge2 , fixedStep2))
+        {
+            const int laneCount = count - i < 4 ? count - i : 4;
+
+            //coverage mask, inside when no edge value has its sign bit set
+            const __m128 inside = testCoverage ? _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(fixedEdge0 , fixedEdge1) , fixedEdge2)
+                , minusOne)) : allLanes;
+            if((_mm_movemask_ps(inside) & GetLaneMask(laneCount)) == 0) continue;
+
+            const __m128 weight0 = _mm_add_ps(rowBase0 , _mm_mul_ps(step0 , offset));
+            const __m128 weight1 = _mm_add_ps(rowBase1 , _mm_mul_ps(step1 , offset));
+            const __m128 weight2 = _mm_add_ps(rowBase2 , _mm_mul_ps(step2 , offset));
+
+            //the tail of the span can't be loaded directly
+            for(int lane = 0; lane < 4; ++lane) depthRow[lane] = lane < laneCount ? pDepthRow[i + lane] : 0.0f;
+
+            const __m128 zBuffer = _mm_add_ps(_mm_add_ps(_mm_mul_ps(weight0 , z0) , _mm_mul_ps(weight1 , z1)) , _mm_mul_ps(weight2 , z2));
+
+            const __m128 depthPass = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(zBuffer , one) , _mm_cmpge_ps(zBuffer , zero))
+                , _mm_cmplt_ps(zBuffer , _mm_load_ps(depthRow)));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(inside , depthPass))) & GetLaneMask(laneCount);
+            if(mask == 0) continue;
+
+            _mm_store_ps(weights0 , weight0);
+            _mm_store_ps(weights1 , weight1);
+            _mm_store_ps(weights2 , weight2);
+            _mm_store_ps(depths , zBuffer);
+            fragmentCount += EmitFragments(mask , left + i , weights0 , weights1 , weights2 , depths , pFragments + fragmentCount);
+        }
+        return fragmentCount;
+    }
+
+    /// @brief 8 pixels per instruction
+    SOFTWARE_TARGET_AVX2 uint32_t RasterizeSpanAVX2(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept
+    {
+        const float column = static_cast<float>(left);
+        const __m256 rowBase0 = _mm256_set1_ps(edges.edge0[0] * column + (edges.edge0[1] * static_cast<float>(row) + edges.edge0[2]));
+        const __m256 rowBase1 = _mm256_set1_ps(edges.edge1[0] * column + (edges.edge1[1] * static_cast<float>(row) + edges.edge1[2]));
+        const __m256 rowBase2 = _mm256_set1_ps(edges.edge2[0] * column + (edges.edge2[1] * static_cast<float>(row) + edges.edge2[2]));
+        const __m256 step0 = _mm256_set1_ps(edges.edge0[0]);
+        const __m256 step1 = _mm256_set1_ps(edges.edge1[0]);
+        const __m256 step2 = _mm256_set1_ps(edges.edge2[0]);
+        const __m256 z0 = _mm256_set1_ps(edges.vertex0Z);
+        const __m256 z1 = _mm256_set1_ps(edges.vertex1Z);
+        const __m256 z2 = _mm256_set1_ps(edges.vertex2Z);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 allLanes = _mm256_cmp_ps(zero , zero , _CMP_EQ_OQ);
+
+        //the fixed point edges of the first 8 pixels, stepped with integer adds
+        //no lambda, it wouldn't get the avx2 target of this function
+        const __m256i laneIndices = _mm256_setr_epi32(0 , 1 , 2 , 3 , 4 , 5 , 6 , 7);
+        __m256i fixedEdge0 = _mm256_add_epi32(_mm256_set1_epi32(GetSpanEdgeStart(edges.fixedEdges[0] , left , row))
+            , _mm256_mullo_epi32(laneIndices , _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[0].stepX))));
+        __m256i fixedEdge1 = _mm256_add_epi32(_mm256_set1_epi32(GetSpanEdgeStart(edges.fixedEdges[1] , left , row))
+            , _mm256_mullo_epi32(laneIndices , _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[1].stepX))));
+        __m256i fixedEdge2 = _mm256_add_epi32(_mm256_set1_epi32(GetSpanEdgeStart(edges.fixedEdges[2] , left , row))
+            , _mm256_mullo_epi32(laneIndices , _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[2].stepX))));
+        const __m256i fixedStep0 = _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[0].stepX * 8));
+        const __m256i fixedStep1 = _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[1].stepX * 8));
+        const __m256i fixedStep2 = _mm256_set1_epi32(static_cast<int32_t>(edges.fixedEdges[2].stepX * 8));
+        const __m256i minusOne = _mm256_set1_epi32(-1);
+
+        alignas(32) float weights0[8] , weights1[8] , weights2[8] , depths[8] , depthRow[8];
+
+        uint32_t fragmentCount = 0;
+        __m256 offset = _mm256_setr_ps(0.0f , 1.0f , 2.0f , 3.0f , 4.0f , 5.0f , 6.0f , 7.0f);
+        for(int i = 0; i < count; i += 8 , offset = _mm256_add_ps(offset , _mm256_set1_ps(8.0f)) , fixedEdge0 = _mm256_add_epi32(fixedEdge0 , fixedStep0)
+            , fixedEdge1 = _mm256_add_epi32(fixedEdge1 , fixedStep1) , fixedEdge2 = _mm256_add_epi32(fixedEdge2 , fixedStep2))
+        {
+            const int laneCount = count - i < 8 ? count - i : 8;
+
+            //coverage mask, inside when no edge value has its sign bit set
+            const __m256 inside = testCoverage ? _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_or_si256(_mm256_or_si256(fixedEdge0 , fixedEdge1)
+                , fixedEdge2) , minusOne)) : allLanes;
+            if((_mm256_movemask_ps(inside) & GetLaneMask(laneCount)) == 0) continue;
+
+            const __m256 weight0 = _mm256_add_ps(rowBase0 , _mm256_mul_ps(step0 , offset));
+            const __m256 weight1 = _mm256_add_ps(rowBase1 , _mm256_mul_ps(step1 , offset));
+            const __m256 weight2 = _mm256_add_ps(rowBase2 , _mm256_mul_ps(step2 , offset));
+
+            //the tail of the span can't be loaded directly
+            for(int lane = 0; lane < 8; ++lane) depthRow[lane] = lane < laneCount ? pDepthRow[i + lane] : 0.0f;
+
+            const __m256 zBuffer = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(weight0 , z0) , _mm256_mul_ps(weight1 , z1))
+                , _mm256_mul_ps(weight2 , z2));
+
+            const __m256 depthPass = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(zBuffer , one , _CMP_LE_OQ)
+                , _mm256_cmp_ps(zBuffer , zero , _CMP_GE_OQ)) , _mm256_cmp_ps(zBuffer , _mm256_load_ps(depthRow) , _CMP_LT_OQ));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(inside , depthPass))) & GetLaneMask(laneCount);
+            if(mask == 0) continue;
+
+            _mm256_store_ps(weights0 , weight0);
+            _mm256_store_ps(weights1 , weight1);
+            _mm256_store_ps(weights2 , weight2);
+            _mm256_store_ps(depths , zBuffer);
+            fragmentCount += EmitFragments(mask , left + i , weights0 , weights1 , weights2 , depths , pFragments + fragmentCount);
+        }
+        return fragmentCount;
+    }
+
+    /// @brief test the pixel centers of a block against the three edges, the edge functions are linear so the extremes are in the corners
+    /// @param left first column of the block
+    /// @param top first row of the block
+    /// @param right last column of the block
+    /// @param bottom last row of the block
+    /// @return whether the block is outside, inside or crossing the triangle
+    BlockCoverage ClassifyBlock(const TriangleEdges& edges , int left , int top , int right , int bottom) noexcept
+    {
+        //exact in fixed point, the same answer the per pixel test gives
+        bool isInside = true;
+        for(const FixedPointEdge& edge : edges.fixedEdges)
+        {
+            const int64_t leftValue = edge.stepX * left , rightValue = edge.stepX * right;
+            const int64_t topValue = edge.stepY * top , bottomValue = edge.stepY * bottom;
+
+            const int64_t maxValue = edge.constant + std::max(leftValue , rightValue) + std::max(topValue , bottomValue);
+            if(maxValue < 0) return BlockCoverage::Outside;
+
+            const int64_t minValue = edge.constant + std::min(leftValue , rightValue) + std::min(topValue , bottomValue);
+            if(minValue < 0) isInside = false;
+        }
+        return isInside ? BlockCoverage::Inside : BlockCoverage::Partial;
+    }
+
+    /// @brief check which instruction sets the cpu and the os support
+    /// @return the widest supported instruction set
+    SimdLevel DetectSimdLevel() noexcept
+    {
+    #if defined(_MSC_VER)
+        int cpuInfo[4];
+        __cpuid(cpuInfo , 0);
+        if(cpuInfo[0] < 7) return SimdLevel::SSE;
+
+        //the os has to save the ymm registers (osxsave + xcr0 bits 1 and 2)
+        __cpuid(cpuInfo , 1);
+        const bool hasOSXSave = (cpuInfo[2] & (1 << 27)) != 0;
+        if(!hasOSXSave || (_xgetbv(0) & 0x6) != 0x6) return SimdLevel::SSE;
+
+        __cpuidex(cpuInfo , 7 , 0);
+        return (cpuInfo[1] & (1 << 5)) != 0 ? SimdLevel::AVX2 : SimdLevel::SSE;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE;
+    #endif
+    }
+
+    /// @brief get the span rasterizer for an instruction set
+    /// @param level the requested instruction set, gets lowered to what the cpu supports
+    /// @return the span function
+    RasterizeSpanFunction GetRasterizeSpanFunction(SimdLevel level) noexcept
+    {
+        static const SimdLevel supportedLevel = DetectSimdLevel();
+        if(level > supportedLevel) level = supportedLevel;
+
+        switch(level)
+        {
+            case SimdLevel::AVX2:
+                return RasterizeSpanAVX2;
+            case SimdLevel::SSE:
+                return RasterizeSpanSSE;
+            case SimdLevel::Scalar:
+                return RasterizeSpanScalar;
+            default:
+                return RasterizeSpanScalar;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+
+// - Project includes -
+#include "EMath.h"
+
+namespace software
+{
+    /// @brief the instruction sets the span rasterizer can use, picked at runtime
+    enum class SimdLevel
+    {
+        Scalar ,
+        SSE ,
+        AVX2
+    };
+
+    /// @brief sub pixel precision of the raster space vertices, 28.4 fixed point
+    constexpr int SubPixelBits{4};
+    constexpr int SubPixelSteps{1 << SubPixelBits};
+
+    /// @brief an edge function in fixed point, exact for vertices snapped to the sub pixel grid
+    /// @brief value(column, row) = stepX * column + stepY * row + constant at the center of the pixel
+    /// @brief the pixel is inside the edge when the value is >= 0, the top-left fill rule is part of the constant
+    struct FixedPointEdge
+    {
+        int64_t stepX;
+        int64_t stepY;
+        int64_t constant;
+    };
+
+    /// @brief the three edge functions of a triangle
+    /// @brief coverage uses the fixed point edges, so pixels on an edge shared by two triangles belong to exactly one of them
+    /// @brief the float edges are prescaled by the inverse area so they return barycentric weights directly, at the pixel center
+    /// @brief weightN(x, y) = edgeN[0] * x + edgeN[1] * y + edgeN[2]
+    struct TriangleEdges
+    {
+        FixedPointEdge fixedEdges[3];
+        float edge0[3];
+        float edge1[3];
+        float edge2[3];
+        float vertex0Z; //ndc z per vertex, z / w is affine in screen space so the depth interpolates linearly
+        float vertex1Z;
+        float vertex2Z;
+    };
+
+    /// @brief result of testing a block of pixels against the three edges of a triangle
+    enum class BlockCoverage
+    {
+        Outside , //no pixel of the block is inside the triangle
+        Inside , //every pixel of the block is inside the triangle
+        Partial //the block crosses an edge, every pixel needs to be tested
+    };
+
+    /// @brief a pixel of a span that is inside the triangle and passed the depth test
+    struct RasterFragment
+    {
+        uint32_t x;
+        float weight0;
+        float weight1;
+        float weight2;
+        float depth;
+    };
+
+    /// @brief find the covered pixels of a row span that pass the depth test
+    /// @param edges the triangle's edge equations
+    /// @param left first column of the span
+    /// @param row the row of the span
+    /// @param count amount of pixels in the span, at most TileSize
+    /// @param pDepthRow depth buffer values of the span, pDepthRow[0] belongs to column left
+    /// @param pFragments output, needs room for count fragments
+    /// @param testCoverage false when the span is known to be inside the triangle, only the depth test is done
+    /// @return the amount of written fragments
+    using RasterizeSpanFunction = uint32_t(*)(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage);
+
+    float SnapToSubPixel(float coordinate) noexcept;
+    int64_t GetFixedPointArea(const Elite::FPoint4& vertex0 , const Elite::FPoint4& vertex1 , const Elite::FPoint4& vertex2) noexcept;
+
+    TriangleEdges SetupTriangleEdges(const Elite::FPoint4& vertex0 , const Elite::FPoint4& vertex1 , const Elite::FPoint4& vertex2
+        , float areaParallelogram) noexcept;
+
+    uint32_t RasterizeSpanScalar(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept;
+    uint32_t RasterizeSpanSSE(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept;
+    uint32_t RasterizeSpanAVX2(const TriangleEdges& edges , int left , int row , int count
+        , const float* pDepthRow , RasterFragment* pFragments , bool testCoverage) noexcept;
+
+    uint32_t CountSpanCoverage(const TriangleEdges& edges , int left , int row , int count) noexcept;
+
+    BlockCoverage ClassifyBlock(const TriangleEdges& edges , int left , int top , int right , int bottom) noexcept;
+
+    SimdLevel DetectSimdLevel() noexcept;
+    RasterizeSpanFunction GetRasterizeSpanFunction(SimdLevel level) noexcept;
+}
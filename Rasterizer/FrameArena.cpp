@@ -0,0 +1,69 @@
+#include "FrameArena.h"
+
+// - Standard includes -
+#include <algorithm>
+
+// ---- Constructors ----
+
+/// @brief creates the arena with one block
+/// @param initialCapacity the size in bytes of the first block
+FrameArena::FrameArena(size_t initialCapacity)
+    : m_Offset{0}
+    , m_UsedBytes{0}
+{
+    //a few blocks at most before they get merged
+    m_Blocks.reserve(8);
+    AddBlock(initialCapacity);
+}
+
+// ---- Functionality ----
+
+/// @brief release everything of the previous frame, merges the blocks when the previous frame didn't fit in one
+void FrameArena::Reset()
+{
+    if(m_Blocks.size() > 1)
+    {
+        //room for everything of the previous frame, with some headroom for the next
+        const size_t capacity = GetCapacity() + GetCapacity() / 2;
+        m_Blocks.clear();
+        AddBlock(capacity);
+    }
+
+    m_Offset = 0;
+    m_UsedBytes = 0;
+}
+
+/// @brief bump allocate memory, never fails
+/// @param size the amount of bytes
+/// @param alignment power of 2 alignment of the returned address
+/// @return the memory, valid until the next Reset
+void* FrameArena::Allocate(size_t size , size_t alignment)
+{
+    Block* pBlock = &m_Blocks.back();
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(pBlock->pData.get()) + m_Offset;
+    size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+    if(m_Offset + padding + size > pBlock->capacity)
+    {
+        //overflow, a new block that fits this allocation and then some
+        AddBlock(std::max(pBlock->capacity , size + alignment) * 2);
+        pBlock = &m_Blocks.back();
+        address = reinterpret_cast<uintptr_t>(pBlock->pData.get());
+        padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+    }
+
+    m_Offset += padding + size;
+    m_UsedBytes += padding + size;
+    return reinterpret_cast<void*>(address + padding);
+}
+
+// ---- Private Functions ----
+
+/// @brief add a block and make it the current one
+/// @param capacity the size in bytes of the block
+void FrameArena::AddBlock(size_t capacity)
+{
+    m_Blocks.push_back(Block{std::make_unique_for_overwrite<std::byte[]>(capacity) , capacity});
+    m_Offset = 0;
+}
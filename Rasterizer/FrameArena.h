@@ -0,0 +1,90 @@
+#pragma once
+
+// - Standard includes -
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/// @brief A linear allocator for the temporaries of one software frame (transformed vertices, triangles, tile bins)
+/// @brief Allocating is a pointer bump, everything is released at once by Reset at the start of the next frame
+/// @brief When a frame needs more than the capacity, an extra block is added, the next Reset merges them into one
+/// @brief so in a steady state there are no heap allocations at all
+class FrameArena final
+{
+public:
+
+      // ---- Constructors ----
+    explicit FrameArena(size_t initialCapacity = size_t(1) << 20);
+
+    // ---- Destructor ----
+    ~FrameArena() = default;
+
+    // ---- Copy/Move ----
+    FrameArena(const FrameArena& other) = delete; //copy constructor
+    FrameArena(FrameArena&& other) noexcept = delete; //move constructor
+    FrameArena& operator=(const FrameArena& other) = delete; // copy assignment
+    FrameArena& operator=(FrameArena&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void Reset();
+    void* Allocate(size_t size , size_t alignment);
+
+    template<typename T>
+    std::span<T> AllocateArray(size_t count);
+
+    // -- Getters --
+    size_t GetUsedBytes() const noexcept;
+    size_t GetCapacity() const noexcept;
+
+private:
+
+      // ---- Private Functions ----
+    void AddBlock(size_t capacity);
+
+    // ---- Data members ----
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> pData;
+        size_t capacity;
+    };
+
+    std::vector<Block> m_Blocks;
+    size_t m_Offset; //offset in the last block
+    size_t m_UsedBytes; //over all blocks, including alignment padding
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+/// @brief allocate an array of a type that needs no destructor, the elements are default initialized
+/// @param count the amount of elements
+/// @return the array, valid until the next Reset
+template<typename T>
+inline std::span<T> FrameArena::AllocateArray(size_t count)
+{
+    static_assert(std::is_trivially_destructible_v<T> , "the arena never calls destructors");
+
+    if(count == 0) return {};
+
+    //cache line alignment, also enough for any simd load
+    T* const pArray = static_cast<T*>(Allocate(sizeof(T) * count , alignof(T) > 64 ? alignof(T) : 64));
+    std::uninitialized_default_construct_n(pArray , count);
+    return std::span<T>{pArray , count};
+}
+
+// -- Getters --
+inline size_t FrameArena::GetUsedBytes() const noexcept
+{
+    return m_UsedBytes;
+}
+
+inline size_t FrameArena::GetCapacity() const noexcept
+{
+    size_t capacity = 0;
+    for(const Block& block : m_Blocks) capacity += block.capacity;
+    return capacity;
+}
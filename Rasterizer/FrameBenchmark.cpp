@@ -0,0 +1,167 @@
+#include "FrameBenchmark.h"
+#include "AllocationCounter.h"
+#include "PipelineStats.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+    /// @brief nearest rank percentile of sorted values
+    double GetPercentile(const std::vector<double>& sortedValues , double percentile)
+    {
+        const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sortedValues.size()));
+        return sortedValues[std::clamp<size_t>(rank , 1 , sortedValues.size()) - 1];
+    }
+
+    /// @brief the path of the image of a frame in a directory
+    std::string GetFrameImagePath(const std::string& directory , uint32_t frame)
+    {
+        char fileName[32];
+        std::snprintf(fileName , sizeof(fileName) , "/frame_%04u.bmp" , frame);
+        return directory + fileName;
+    }
+
+    /// @brief compare a color buffer with a golden image
+    /// @return true if the sizes match and no color channel differs more than maxChannelDifference
+    bool GetIsMatchingGoldenImage(const SDL_Surface* pColorBuffer , const std::string& goldenPath , uint32_t maxChannelDifference)
+    {
+        SDL_Surface* const pLoaded = SDL_LoadBMP(goldenPath.c_str());
+        if(!pLoaded) return false;
+
+        //same pixel format as the color buffer, so the pixels compare directly
+        SDL_Surface* const pGolden = SDL_ConvertSurface(pLoaded , pColorBuffer->format , 0);
+        SDL_FreeSurface(pLoaded);
+        if(!pGolden) return false;
+
+        bool isMatching = pGolden->w == pColorBuffer->w && pGolden->h == pColorBuffer->h;
+        for(int r = 0; isMatching && r < pColorBuffer->h; ++r)
+        {
+            const uint32_t* pRow = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pColorBuffer->pixels) + r * pColorBuffer->pitch);
+            const uint32_t* pGoldenRow = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pGolden->pixels) + r * pGolden->pitch);
+            for(int c = 0; c < pColorBuffer->w; ++c)
+            {
+                for(uint32_t shift = 0; shift < 24; shift += 8)
+                {
+                    const int channel = static_cast<int>((pRow[c] >> shift) & 0xFF);
+                    const int goldenChannel = static_cast<int>((pGoldenRow[c] >> shift) & 0xFF);
+                    if(static_cast<uint32_t>(std::abs(channel - goldenChannel)) > maxChannelDifference) isMatching = false;
+                }
+            }
+        }
+
+        SDL_FreeSurface(pGolden);
+        return isMatching;
+    }
+}
+
+/// @brief get the camera pose at a time on the path, linear between the keyframes
+/// @param cameraPath keyframes sorted on time, at least one
+/// @param time seconds from the start, clamped to the path
+/// @return the interpolated pose
+CameraKeyframe SampleCameraPath(const std::vector<CameraKeyframe>& cameraPath , float time)
+{
+    if(time <= cameraPath.front().time) return cameraPath.front();
+    if(time >= cameraPath.back().time) return cameraPath.back();
+
+    const auto next = std::upper_bound(cameraPath.begin() , cameraPath.end() , time
+        , [](float t , const CameraKeyframe& keyframe) { return t < keyframe.time; });
+    const CameraKeyframe& from = *(next - 1);
+    const CameraKeyframe& to = *next;
+
+    const float t = (time - from.time) / (to.time - from.time);
+    return CameraKeyframe
+    {
+        time,
+        Elite::FPoint3{from.position.x + (to.position.x - from.position.x) * t
+            , from.position.y + (to.position.y - from.position.y) * t
+            , from.position.z + (to.position.z - from.position.z) * t},
+        from.forward + (to.forward - from.forward) * t
+    };
+}
+
+/// @brief render the active scene with the software renderer along the camera path and measure the frame times
+/// @brief the time step is fixed, so the same settings render the same frames on any machine
+/// @param renderer the renderer, windowed or headless
+/// @param settings the camera path, the amount of frames and where to write or compare the images
+/// @return the frame time percentiles of the measured frames
+FrameBenchmarkResult RunFrameBenchmark(Renderer& renderer , const FrameBenchmarkSettings& settings)
+{
+    Camera* const camera = CameraManager::GetInstance()->GetCamera();
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(settings.frameCount);
+
+    FrameBenchmarkResult result{};
+
+    for(uint32_t frame = 0; frame < settings.warmupFrameCount + settings.frameCount; ++frame)
+    {
+        const bool isMeasured = frame >= settings.warmupFrameCount;
+        const uint32_t measuredFrame = frame - settings.warmupFrameCount;
+
+        if(!settings.cameraPath.empty())
+        {
+            const CameraKeyframe pose = SampleCameraPath(settings.cameraPath , isMeasured ? measuredFrame * settings.frameDeltaTime : 0.0f);
+            camera->SetPose(pose.position , pose.forward);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        renderer.RenderSoftware();
+        const auto end = std::chrono::steady_clock::now();
+
+        if(!isMeasured) continue;
+
+        frameTimes.push_back(std::chrono::duration<double , std::milli>(end - start).count());
+
+        //after the warmup every buffer and the frame arena are big enough
+        if(renderer.GetSoftwareFrameAllocationCount() > 0) ++result.allocatingFrames;
+
+        if(!settings.dumpDirectory.empty())
+        {
+            const std::string path = GetFrameImagePath(settings.dumpDirectory , measuredFrame);
+            if(!renderer.SaveColorBuffer(path)) std::cout << "frame benchmark: couldn't write " << path << '\n';
+        }
+
+        if(!settings.goldenDirectory.empty()
+            && !GetIsMatchingGoldenImage(renderer.GetColorBuffer() , GetFrameImagePath(settings.goldenDirectory , measuredFrame)
+                , settings.maxChannelDifference))
+        {
+            ++result.goldenMismatchFrames;
+        }
+    }
+
+    //stage times and counters of the last frame
+    SOFTWARE_STATS_CODE(renderer.PrintSoftwarePipelineStats());
+
+    if(frameTimes.empty()) return result;
+
+    result.frameCount = static_cast<uint32_t>(frameTimes.size());
+    result.meanMilliseconds = std::accumulate(frameTimes.begin() , frameTimes.end() , 0.0) / frameTimes.size();
+
+    std::sort(frameTimes.begin() , frameTimes.end());
+    result.minMilliseconds = frameTimes.front();
+    result.p50Milliseconds = GetPercentile(frameTimes , 50.0);
+    result.p90Milliseconds = GetPercentile(frameTimes , 90.0);
+    result.p99Milliseconds = GetPercentile(frameTimes , 99.0);
+    result.maxMilliseconds = frameTimes.back();
+    return result;
+}
+
+/// @brief print the frame times of a benchmark run
+/// @param result the result of RunFrameBenchmark
+void PrintFrameBenchmarkResult(const FrameBenchmarkResult& result)
+{
+    std::cout << "frame benchmark, " << result.frameCount << " frames\n"
+        << "mean " << result.meanMilliseconds << " ms, min " << result.minMilliseconds << " ms, p50 " << result.p50Milliseconds
+        << " ms, p90 " << result.p90Milliseconds << " ms, p99 " << result.p99Milliseconds << " ms, max " << result.maxMilliseconds << " ms\n";
+
+    if(result.goldenMismatchFrames > 0) std::cout << result.goldenMismatchFrames << " frames differ from the golden images\n";
+    if(result.allocatingFrames > 0) std::cout << result.allocatingFrames << " frames did heap allocations\n";
+    if(!software::IsHeapAllocationCounted()) std::cout << "heap allocations not counted, build with SOFTWARE_COUNT_ALLOCATIONS\n";
+}
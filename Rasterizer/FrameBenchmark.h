@@ -0,0 +1,50 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+
+// - Forward Declaration -
+class Renderer;
+
+/// @brief a pose on the scripted camera path of the frame benchmark
+struct CameraKeyframe
+{
+    float time; //seconds from the start of the path
+    Elite::FPoint3 position;
+    Elite::FVector3 forward;
+};
+
+/// @brief what the frame benchmark renders, the software renderer along a camera path with a fixed time step
+struct FrameBenchmarkSettings
+{
+    std::vector<CameraKeyframe> cameraPath; //sorted on time
+    uint32_t frameCount{300};
+    uint32_t warmupFrameCount{10}; //rendered but not measured, fills the caches and the frame arena
+    float frameDeltaTime{1.0f / 60.0f}; //fixed step along the path, so every run renders the same frames
+    std::string dumpDirectory; //empty: no images written
+    std::string goldenDirectory; //empty: no comparison
+    uint32_t maxChannelDifference{2}; //per color channel, a pixel with a bigger difference counts as a mismatch
+};
+
+/// @brief frame times of the measured frames, in milliseconds
+struct FrameBenchmarkResult
+{
+    uint32_t frameCount;
+    double meanMilliseconds;
+    double minMilliseconds;
+    double p50Milliseconds;
+    double p90Milliseconds;
+    double p99Milliseconds;
+    double maxMilliseconds;
+    uint32_t goldenMismatchFrames; //frames with at least one pixel different from the golden image
+    uint32_t allocatingFrames; //frames that did heap allocations, only counted with SOFTWARE_COUNT_ALLOCATIONS
+};
+
+CameraKeyframe SampleCameraPath(const std::vector<CameraKeyframe>& cameraPath , float time);
+FrameBenchmarkResult RunFrameBenchmark(Renderer& renderer , const FrameBenchmarkSettings& settings);
+void PrintFrameBenchmarkResult(const FrameBenchmarkResult& result);
@@ -0,0 +1,66 @@
+//main of the frame benchmark executable, headless so it runs on hosts without a display
+//usage: FrameBenchmark [frameCount] [dumpDirectory] [goldenDirectory]
+//exits with 0 when every check passed, 1 when one failed and 2 when there is no scene to run on
+//built with SOFTWARE_COUNT_ALLOCATIONS, a measured frame that does a heap allocation fails too
+int main(int argc , char* argv[])
+{
+    //only the surfaces are needed, no video subsystem
+    SDL_Init(0);
+
+    const uint32_t width = 640;
+    const uint32_t height = 480;
+
+    //no window, the software renderer draws into an in-memory color buffer
+    Renderer* pRenderer = new Renderer(nullptr);
+    pRenderer->InitializeHeadless(width , height);
+
+    //the scene and the camera come from the game that links this executable, it has no content of its own
+    //without them there is nothing to render or compare, and switching the renderer would touch a null camera
+    const auto* const pScene = SceneManager::GetInstance()->GetActiveScene();
+    if(!pScene || pScene->GetPrimitives().empty() || !CameraManager::GetInstance()->GetCamera())
+    {
+        std::cerr << "FrameBenchmark: no active scene with primitives or no camera, set them up before the benchmark runs\n";
+        delete pRenderer;
+        SDL_Quit();
+        return 2;
+    }
+
+    //switch to the software renderer, the camera follows its coordinate convention
+    GameManager::GetInstance()->SwitchRenderFunction();
+
+    FrameBenchmarkSettings settings{};
+    settings.frameCount = (argc > 1) ? static_cast<uint32_t>(std::stoul(argv[1])) : settings.frameCount;
+    settings.dumpDirectory = (argc > 2) ? argv[2] : "";
+    settings.goldenDirectory = (argc > 3) ? argv[3] : "";
+
+    //a fly around the origin, 5 seconds
+    settings.cameraPath =
+    {
+        {0.0f , {0.0f , 5.0f , 65.0f} , {0.0f , 0.0f , 1.0f}},
+        {2.5f , {40.0f , 10.0f , 40.0f} , {0.7f , 0.0f , 0.7f}},
+        {5.0f , {0.0f , 5.0f , 25.0f} , {0.0f , 0.0f , 1.0f}}
+    };
+
+    const FrameBenchmarkResult result = RunFrameBenchmark(*pRenderer , settings);
+    PrintFrameBenchmarkResult(result);
+
+    //the specialized raster kernels against the runtime one, at the last camera of the path
+    pRenderer->BenchmarkRasterKernels(settings.frameCount);
+
+    //the index buffers in vertex cache and overdraw order against the source order, same camera
+    pRenderer->BenchmarkMeshOptimization(settings.frameCount);
+
+    //shading low contrast blocks once per 2x2 or 4x4 pixels against shading every pixel, time and image difference
+    pRenderer->BenchmarkVariableRateShading(settings.frameCount);
+
+    //every pixel of a dense mesh shaded once, no cracks and no double shading on shared edges
+    const bool isFillRuleCorrect = pRenderer->VerifyRasterFillRule(60);
+
+    //a triangle through the near plane keeps the depth of its plane, the clipped vertices sit on z = 0
+    const bool isNearPlaneClippingCorrect = pRenderer->VerifyNearPlaneClipping();
+
+    delete pRenderer;
+    SDL_Quit();
+
+    return (result.goldenMismatchFrames == 0 && result.allocatingFrames == 0 && isFillRuleCorrect && isNearPlaneClippingCorrect) ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "FramePipeline.h"
+
+// - Standard includes -
+#include <utility>
+
+// ---- Constructors ----
+
+/// @brief creates the pipeline and starts its render thread
+/// @param render draws a snapshot up to the resolve, called on the render thread, it must not make sdl video calls
+/// @param beginPresent picks and locks the surface the render resolves into, called on the thread running the frames
+/// @param present shows the resolved frame, called on the thread running the frames
+FramePipeline::FramePipeline(std::function<void(const FrameSnapshot&)> render , std::function<void()> beginPresent
+    , std::function<void()> present)
+    : m_Render{std::move(render)}
+    , m_BeginPresent{std::move(beginPresent)}
+    , m_Present{std::move(present)}
+    , m_ReadIndex{0}
+    , m_HasReadSnapshot{false}
+    , m_RenderedFrameCount{0}
+    , m_IsRenderRequested{false}
+    , m_IsShuttingDown{false}
+{
+    m_RenderThread = std::thread{[this] { RenderLoop(); }};
+}
+
+// ---- Destructor ----
+
+FramePipeline::~FramePipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_Mutex};
+        m_IsShuttingDown = true;
+    }
+    m_WakeCondition.notify_one();
+
+    m_RenderThread.join();
+}
+
+// ---- Functionality ----
+
+/// @brief draw the snapshot of the last update on the render thread while the update of the next frame runs on the calling thread
+/// @brief returns when both are done and the frame is presented, then the new snapshot becomes the one the next frame draws
+/// @param update moves the camera and the primitives and can change their render state, it must not touch their meshes or materials
+void FramePipeline::RunFrame(const std::function<void()>& update)
+{
+    const bool hasRender = m_HasReadSnapshot;
+    if(hasRender)
+    {
+        m_BeginPresent();
+        {
+            std::lock_guard<std::mutex> lock{m_Mutex};
+            m_IsRenderRequested = true;
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    update();
+    CaptureFrameSnapshot(m_Snapshots[m_ReadIndex ^ 1]);
+
+    if(hasRender)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_Mutex};
+            m_DoneCondition.wait(lock , [this] { return !m_IsRenderRequested; });
+        }
+        m_Present();
+        ++m_RenderedFrameCount;
+    }
+
+    //the handoff, neither side holds a snapshot now
+    m_ReadIndex ^= 1;
+    m_HasReadSnapshot = true;
+}
+
+/// @brief drop the snapshot that is waiting to be drawn, the next frame only updates
+/// @brief for when the renderer switches, the snapshot is stale once this pipeline runs again
+void FramePipeline::Reset() noexcept
+{
+    m_HasReadSnapshot = false;
+}
+
+// ---- Private Functions ----
+
+/// @brief sleeps until a frame gets requested, then draws the read snapshot
+void FramePipeline::RenderLoop()
+{
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_Mutex};
+            m_WakeCondition.wait(lock , [this] { return m_IsShuttingDown || m_IsRenderRequested; });
+            if(m_IsShuttingDown) return;
+        }
+
+        //the calling thread only writes the other snapshot until the render is done
+        m_Render(m_Snapshots[m_ReadIndex]);
+
+        {
+            std::lock_guard<std::mutex> lock{m_Mutex};
+            m_IsRenderRequested = false;
+        }
+        m_DoneCondition.notify_one();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// - Standard includes -
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// - Project includes -
+#include "FrameSnapshot.h"
+
+/// @brief A frame loop where the update of the next frame overlaps the render of the current one
+/// @brief The render thread draws from one snapshot while the update fills the other, they swap once both are done
+/// @brief That adds a frame of latency, what is shown is one update behind the simulation
+/// @brief Presenting stays on the calling thread, the thread that owns the window, the render thread stops after the resolve
+class FramePipeline final
+{
+public:
+
+      // ---- Constructors ----
+    FramePipeline(std::function<void(const FrameSnapshot&)> render , std::function<void()> beginPresent , std::function<void()> present);
+
+    // ---- Destructor ----
+    ~FramePipeline();
+
+    // ---- Copy/Move ----
+    FramePipeline(const FramePipeline& other) = delete; //copy constructor
+    FramePipeline(FramePipeline&& other) noexcept = delete; //move constructor
+    FramePipeline& operator=(const FramePipeline& other) = delete; // copy assignment
+    FramePipeline& operator=(FramePipeline&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void RunFrame(const std::function<void()>& update);
+    void Reset() noexcept;
+
+    // -- Getters --
+    uint64_t GetRenderedFrameCount() const noexcept;
+
+private:
+
+      // ---- Private Functions ----
+    void RenderLoop();
+
+    // ---- Data members ----
+    std::function<void(const FrameSnapshot&)> m_Render;
+    std::function<void()> m_BeginPresent; //calling thread, before the render thread gets woken
+    std::function<void()> m_Present; //calling thread, after the render thread finished
+    FrameSnapshot m_Snapshots[2];
+    uint32_t m_ReadIndex; //the snapshot the render thread draws, the other one gets written by the update
+    bool m_HasReadSnapshot; //false until the first update, nothing to draw yet
+    uint64_t m_RenderedFrameCount;
+
+    std::thread m_RenderThread;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_DoneCondition;
+    bool m_IsRenderRequested;
+    bool m_IsShuttingDown;
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// -- Getters --
+inline uint64_t FramePipeline::GetRenderedFrameCount() const noexcept
+{
+    return m_RenderedFrameCount;
+}
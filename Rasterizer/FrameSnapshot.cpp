@@ -0,0 +1,25 @@
+#include "FrameSnapshot.h"
+
+/// @brief copy the transforms and render states of the active scene and the camera into a snapshot
+/// @brief the vectors keep their storage between captures, in a steady state this doesn't allocate
+/// @param snapshot the snapshot to overwrite
+void CaptureFrameSnapshot(FrameSnapshot& snapshot)
+{
+    const std::vector<Primitive*>& primitives = SceneManager::GetInstance()->GetActiveScene()->GetPrimitives();
+
+    snapshot.primitives.assign(primitives.begin() , primitives.end());
+    snapshot.worldMatrices.resize(primitives.size());
+    snapshot.renderStates.resize(primitives.size());
+    for(size_t i = 0; i < primitives.size(); ++i)
+    {
+        const Primitive* const primitive = primitives[i];
+        snapshot.worldMatrices[i] = primitive->GetWorldMatrix();
+        snapshot.renderStates[i] = PrimitiveRenderState{primitive->GetModelCullMode() , primitive->GetShouldWriteDepthBuffer()
+            , primitive->GetShouldBlend()};
+    }
+
+    const Camera* const camera = CameraManager::GetInstance()->GetCamera();
+    snapshot.viewMatrix = camera->GetViewMatrix();
+    snapshot.projectionMatrix = camera->GetProjectionMatrix();
+    snapshot.cameraPosition = camera->GetPosition();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// - Standard includes -
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "Primitive.h"
+
+/// @brief the render state of a primitive the update can change, the render reads it from here and never from the primitive
+struct PrimitiveRenderState
+{
+    ModelCullingMode cullMode;
+    bool shouldWriteDepthBuffer;
+    bool shouldBlend;
+};
+
+/// @brief the scene state the software renderer draws a frame from, captured after the update of the frame
+/// @brief only the state the update changes is copied, the primitives, their meshes and materials are shared by pointer
+/// @brief the update may move primitives, change their render state and move the camera while a snapshot is drawn,
+/// @brief it must not add, remove or remesh primitives or change the materials the pixel shading reads
+struct FrameSnapshot
+{
+    std::vector<Primitive*> primitives; //the primitives of the active scene, in submission order
+    std::vector<Elite::FMatrix4> worldMatrices; //per primitive
+    std::vector<PrimitiveRenderState> renderStates; //per primitive
+    Elite::FMatrix4 viewMatrix;
+    Elite::FMatrix4 projectionMatrix;
+    Elite::FPoint3 cameraPosition;
+};
+
+void CaptureFrameSnapshot(FrameSnapshot& snapshot);
@@ -0,0 +1,39 @@
+#pragma once
+
+// - Standard includes -
+#include <cmath>
+
+// - Project includes -
+#include "EMath.h"
+
+namespace software
+{
+    /// @brief a plane of the view frustum, a point is inside when a * x + b * y + c * z + d >= 0
+    struct FrustumPlane
+    {
+        float a , b , c , d;
+    };
+
+    /// @brief get the planes of the frustum of a view projection matrix, in the space the matrix transforms from (Gribb-Hartmann)
+    /// @brief with a world view projection matrix the planes are in object space
+    /// @param matrix the matrix to clip space, -w <= x , y <= w and 0 <= z <= w
+    /// @param planes output: left, right, bottom, top, near and far, normalized so a * x + b * y + c * z + d is a distance
+    inline void ExtractFrustumPlanes(const Elite::FMatrix4& matrix , FrustumPlane (&planes)[6]) noexcept
+    {
+        const auto row = [&matrix](int r) { return FrustumPlane{matrix(r , 0) , matrix(r , 1) , matrix(r , 2) , matrix(r , 3)}; };
+        const FrustumPlane x = row(0) , y = row(1) , z = row(2) , w = row(3);
+
+        planes[0] = FrustumPlane{w.a + x.a , w.b + x.b , w.c + x.c , w.d + x.d};
+        planes[1] = FrustumPlane{w.a - x.a , w.b - x.b , w.c - x.c , w.d - x.d};
+        planes[2] = FrustumPlane{w.a + y.a , w.b + y.b , w.c + y.c , w.d + y.d};
+        planes[3] = FrustumPlane{w.a - y.a , w.b - y.b , w.c - y.c , w.d - y.d};
+        planes[4] = z;
+        planes[5] = FrustumPlane{w.a - z.a , w.b - z.b , w.c - z.c , w.d - z.d};
+
+        for(FrustumPlane& plane : planes)
+        {
+            const float invLength = 1.0f / std::sqrt(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+            plane = FrustumPlane{plane.a * invLength , plane.b * invLength , plane.c * invLength , plane.d * invLength};
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/// @brief headless render target of the software renderer, for hosts without a window
+/// @brief the frame gets rendered into an in-memory surface, RenderSoftware skips the blit and the window update
+/// @param width width in pixels of the render target
+/// @param height height in pixels of the render target
+void Renderer::InitializeHeadless(uint32_t width , uint32_t height)
+{
+    //no video subsystem, a surface in system memory with the format of the window surface
+    m_pWindow = nullptr;
+    m_pFrontBuffer = nullptr;
+    m_pPresentedSurface = nullptr;
+    m_Width = width;
+    m_Height = height;
+
+    if(m_pBackBuffer) SDL_FreeSurface(m_pBackBuffer);
+    m_pBackBuffer = SDL_CreateRGBSurfaceWithFormat(0 , static_cast<int>(width) , static_cast<int>(height) , 32 , SDL_PIXELFORMAT_ARGB8888);
+}
+
+/// @brief check if the renderer has no window
+/// @return true after InitializeHeadless
+bool Renderer::GetIsHeadless() const noexcept
+{
+    return m_pWindow == nullptr;
+}
+
+/// @brief get the color buffer of the last software frame, the back buffer or the window surface when it was presented directly
+/// @return the surface, owned by the renderer or the window
+const SDL_Surface* Renderer::GetColorBuffer() const noexcept
+{
+    return m_pPresentedSurface ? m_pPresentedSurface : m_pBackBuffer;
+}
+
+/// @brief write the color buffer of the last software frame to a bmp file
+/// @param filePath the path of the image
+/// @return false if the file couldn't be written
+bool Renderer::SaveColorBuffer(const std::string& filePath) const
+{
+    return SDL_SaveBMP(m_pPresentedSurface ? m_pPresentedSurface : m_pBackBuffer , filePath.c_str()) == 0;
+}
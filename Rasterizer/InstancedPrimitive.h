@@ -0,0 +1,59 @@
+#pragma once
+
+// - Standard includes -
+#include <utility>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "Primitive.h"
+
+/// @brief A primitive drawn once per instance transform, every instance shares the mesh, material and render state
+/// @brief The transforms are relative to the world matrix of the primitive, so the world matrix moves the whole group
+/// @brief The software renderer shares the object space streams, meshlets and bounds of the mesh over the instances,
+/// @brief per instance it only transforms the vertices of the visible meshlets, and the group counts as one draw
+class InstancedPrimitive final : public Primitive
+{
+public:
+
+      // ---- Constructors ----
+    template<typename... PrimitiveArguments>
+    explicit InstancedPrimitive(std::vector<Elite::FMatrix4> instanceTransforms , PrimitiveArguments&&... primitiveArguments);
+
+    // ---- Destructor ----
+    ~InstancedPrimitive() override = default;
+
+    // ---- Copy/Move ----
+    InstancedPrimitive(const InstancedPrimitive& other) = delete; //copy constructor
+    InstancedPrimitive(InstancedPrimitive&& other) noexcept = delete; //move constructor
+    InstancedPrimitive& operator=(const InstancedPrimitive& other) = delete; // copy assignment
+    InstancedPrimitive& operator=(InstancedPrimitive&& other) noexcept = delete; //move assignment
+
+    // -- Getters --
+    const std::vector<Elite::FMatrix4>& GetInstanceTransforms() const noexcept;
+
+private:
+
+    // ---- Data members ----
+    //fixed after construction, the scene bvh holds the bounds around all of them
+    const std::vector<Elite::FMatrix4> m_InstanceTransforms;
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// ---- Constructors ----
+/// @param instanceTransforms one transform per instance, relative to the world matrix
+/// @param primitiveArguments the arguments of the primitive the instances share
+template<typename... PrimitiveArguments>
+InstancedPrimitive::InstancedPrimitive(std::vector<Elite::FMatrix4> instanceTransforms , PrimitiveArguments&&... primitiveArguments)
+    : Primitive(std::forward<PrimitiveArguments>(primitiveArguments)...)
+    , m_InstanceTransforms{std::move(instanceTransforms)}
+{}
+
+// -- Getters --
+inline const std::vector<Elite::FMatrix4>& InstancedPrimitive::GetInstanceTransforms() const noexcept
+{
+    return m_InstanceTransforms;
+}
@@ -0,0 +1,233 @@
+#include "MeshCache.h"
+
+// - Standard includes -
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char MeshCacheMagic[4]{'M' , 'S' , 'H' , 'C'};
+
+    /// @brief check a blob of count elements at offset fits in the file, without overflowing on a corrupt header
+    bool GetIsBlobInside(uint64_t offset , uint64_t count , uint64_t stride , uint64_t fileSize) noexcept
+    {
+        return offset <= fileSize && count <= (fileSize - offset) / stride;
+    }
+
+    uint64_t AlignUp(uint64_t offset) noexcept
+    {
+        return (offset + MeshCacheAlignment - 1) / MeshCacheAlignment * MeshCacheAlignment;
+    }
+
+    /// @brief write zeros up to the next aligned offset
+    void WritePadding(std::ofstream& file , uint64_t offset)
+    {
+        constexpr char zeros[MeshCacheAlignment]{};
+        file.write(zeros , static_cast<std::streamsize>(AlignUp(offset) - offset));
+    }
+}
+
+// ---- Destructor ----
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+// ---- Functionality ----
+
+/// @brief map a whole file read only, a previous mapping gets closed
+/// @param filePath the file to map
+/// @return false if the file doesn't exist, is empty or can't be mapped
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+#if defined(_WIN32)
+    m_FileHandle = CreateFileA(filePath.c_str() , GENERIC_READ , FILE_SHARE_READ , nullptr , OPEN_EXISTING , FILE_ATTRIBUTE_NORMAL , nullptr);
+    if(m_FileHandle == INVALID_HANDLE_VALUE)
+    {
+        m_FileHandle = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if(!GetFileSizeEx(m_FileHandle , &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    m_MappingHandle = CreateFileMappingA(m_FileHandle , nullptr , PAGE_READONLY , 0 , 0 , nullptr);
+    if(!m_MappingHandle)
+    {
+        Close();
+        return false;
+    }
+
+    m_pData = static_cast<const std::byte*>(MapViewOfFile(m_MappingHandle , FILE_MAP_READ , 0 , 0 , 0));
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fileDescriptor = open(filePath.c_str() , O_RDONLY);
+    if(fileDescriptor < 0) return false;
+
+    struct stat fileStatus{};
+    if(fstat(fileDescriptor , &fileStatus) != 0 || fileStatus.st_size == 0)
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    //the mapping keeps the file referenced, the descriptor isn't needed anymore
+    void* const pMapping = mmap(nullptr , static_cast<size_t>(fileStatus.st_size) , PROT_READ , MAP_PRIVATE , fileDescriptor , 0);
+    close(fileDescriptor);
+    if(pMapping == MAP_FAILED) return false;
+
+    m_pData = static_cast<const std::byte*>(pMapping);
+    m_Size = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+    if(!m_pData)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+/// @brief unmap the file, every view into it becomes invalid
+void MappedFile::Close() noexcept
+{
+#if defined(_WIN32)
+    if(m_pData) UnmapViewOfFile(m_pData);
+    if(m_MappingHandle) CloseHandle(m_MappingHandle);
+    if(m_FileHandle) CloseHandle(m_FileHandle);
+    m_MappingHandle = nullptr;
+    m_FileHandle = nullptr;
+#else
+    if(m_pData) munmap(const_cast<std::byte*>(m_pData) , m_Size);
+#endif
+
+    m_pData = nullptr;
+    m_Size = 0;
+}
+
+/// @brief map a mesh cache and check it belongs to the source and vertex type
+/// @param cachePath the cache file
+/// @param sourceHash the hash of the source file as it is now
+/// @param vertexStride sizeof the vertex type the caller reads
+/// @return false if the cache is missing, truncated, of another version or built from another source or vertex type
+bool MeshCache::Open(const std::string& cachePath , uint64_t sourceHash , uint32_t vertexStride)
+{
+    Close();
+    if(!m_File.Open(cachePath)) return false;
+
+    const std::span<const std::byte> data = m_File.GetData();
+    if(data.size() < sizeof(MeshCacheHeader))
+    {
+        Close();
+        return false;
+    }
+
+    //the mapping starts page aligned, so the header can be read in place
+    const MeshCacheHeader* const pHeader = reinterpret_cast<const MeshCacheHeader*>(data.data());
+    const bool isValid = std::memcmp(pHeader->magic , MeshCacheMagic , sizeof(MeshCacheMagic)) == 0
+        && pHeader->version == MeshCacheVersion
+        && pHeader->sourceHash == sourceHash
+        && pHeader->vertexStride == vertexStride
+        && pHeader->indexStride == sizeof(uint32_t)
+        && pHeader->vertexOffset % MeshCacheAlignment == 0 && pHeader->indexOffset % MeshCacheAlignment == 0
+        && vertexStride != 0
+        && GetIsBlobInside(pHeader->vertexOffset , pHeader->vertexCount , vertexStride , data.size())
+        && GetIsBlobInside(pHeader->indexOffset , pHeader->indexCount , sizeof(uint32_t) , data.size());
+    if(!isValid)
+    {
+        Close();
+        return false;
+    }
+
+    m_pHeader = pHeader;
+    return true;
+}
+
+/// @brief unmap the cache, the vertex and index views become invalid
+void MeshCache::Close() noexcept
+{
+    m_pHeader = nullptr;
+    m_File.Close();
+}
+
+/// @brief write a mesh cache, the header followed by the vertex and the index blob at aligned offsets
+/// @param cachePath the file to write, replaced if it exists
+/// @param sourceHash the hash of the source file the mesh was loaded from
+/// @param vertices the vertex buffer as raw bytes
+/// @param vertexStride sizeof the vertex type
+/// @param indices the index buffer
+/// @return false if the file couldn't be written
+bool MeshCache::Write(const std::string& cachePath , uint64_t sourceHash , std::span<const std::byte> vertices , uint32_t vertexStride
+    , std::span<const uint32_t> indices)
+{
+    MeshCacheHeader header{};
+    std::memcpy(header.magic , MeshCacheMagic , sizeof(MeshCacheMagic));
+    header.version = MeshCacheVersion;
+    header.sourceHash = sourceHash;
+    header.vertexStride = vertexStride;
+    header.indexStride = sizeof(uint32_t);
+    header.vertexCount = vertices.size() / vertexStride;
+    header.indexCount = indices.size();
+    header.vertexOffset = AlignUp(sizeof(MeshCacheHeader));
+    header.indexOffset = AlignUp(header.vertexOffset + vertices.size());
+
+    //written to a temporary file and renamed, a crash halfway never leaves a cache that looks valid
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file{temporaryPath , std::ios::binary | std::ios::trunc};
+        if(!file) return false;
+
+        file.write(reinterpret_cast<const char*>(&header) , sizeof(header));
+        WritePadding(file , sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertices.data()) , static_cast<std::streamsize>(vertices.size()));
+        WritePadding(file , header.vertexOffset + vertices.size());
+        file.write(reinterpret_cast<const char*>(indices.data()) , static_cast<std::streamsize>(indices.size_bytes()));
+        if(!file) return false;
+    }
+
+    std::remove(cachePath.c_str());
+    return std::rename(temporaryPath.c_str() , cachePath.c_str()) == 0;
+}
+
+/// @brief hash the contents of a file with 64 bit FNV-1a, to find out if a mesh cache is stale
+/// @param filePath the file to hash
+/// @return the hash, 0 if the file can't be read
+uint64_t HashFile(const std::string& filePath)
+{
+    MappedFile file;
+    if(!file.Open(filePath)) return 0;
+
+    uint64_t hash = 14695981039346656037ull;
+    for(const std::byte value : file.GetData())
+    {
+        hash = (hash ^ static_cast<uint64_t>(value)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/// @brief get the path of the mesh cache of a source mesh file, next to it
+/// @param sourcePath the mesh file
+/// @return the source path with the cache extension added
+std::string GetMeshCachePath(const std::string& sourcePath)
+{
+    return sourcePath + ".meshcache";
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+// - Standard includes -
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// - Project includes -
+#include "MeshOptimizer.h"
+
+/// @brief the start of a mesh cache file, the vertex and index blobs follow at aligned offsets
+/// @brief a cache is only used when the version, the hash of its source file and the vertex stride all match
+struct MeshCacheHeader
+{
+    char magic[4]; //"MSHC"
+    uint32_t version;
+    uint64_t sourceHash; //FNV-1a of the source mesh file the cache was built from
+    uint32_t vertexStride; //sizeof the vertex type that was written
+    uint32_t indexStride; //sizeof(uint32_t)
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t vertexOffset; //from the start of the file, multiple of MeshCacheAlignment
+    uint64_t indexOffset; //from the start of the file, multiple of MeshCacheAlignment
+};
+
+/// @brief bump when the layout of the file, a cached vertex type or the optimization of the buffers changes, older caches get rebuilt
+constexpr uint32_t MeshCacheVersion{2};
+
+/// @brief alignment of the blobs in the file, a cache line so the mapped vertices can be read with aligned loads
+constexpr uint64_t MeshCacheAlignment{64};
+
+/// @brief A read only memory mapping of a whole file, unmapped when it goes out of scope
+class MappedFile final
+{
+public:
+
+      // ---- Constructors ----
+    MappedFile() = default;
+
+    // ---- Destructor ----
+    ~MappedFile();
+
+    // ---- Copy/Move ----
+    MappedFile(const MappedFile& other) = delete; //copy constructor
+    MappedFile(MappedFile&& other) noexcept = delete; //move constructor
+    MappedFile& operator=(const MappedFile& other) = delete; // copy assignment
+    MappedFile& operator=(MappedFile&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    bool Open(const std::string& filePath);
+    void Close() noexcept;
+
+    // -- Getters --
+    std::span<const std::byte> GetData() const noexcept;
+
+private:
+
+    // ---- Data members ----
+    const std::byte* m_pData{nullptr};
+    size_t m_Size{0};
+#if defined(_WIN32)
+    void* m_FileHandle{nullptr};
+    void* m_MappingHandle{nullptr};
+#endif
+};
+
+/// @brief A mesh cache file mapped into memory, the vertices and indices are views into the mapping
+/// @brief Nothing gets parsed or constructed, the views stay valid until the cache is closed
+class MeshCache final
+{
+public:
+
+      // ---- Constructors ----
+    MeshCache() = default;
+
+    // ---- Destructor ----
+    ~MeshCache() = default;
+
+    // ---- Copy/Move ----
+    MeshCache(const MeshCache& other) = delete; //copy constructor
+    MeshCache(MeshCache&& other) noexcept = delete; //move constructor
+    MeshCache& operator=(const MeshCache& other) = delete; // copy assignment
+    MeshCache& operator=(MeshCache&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    bool Open(const std::string& cachePath , uint64_t sourceHash , uint32_t vertexStride);
+    void Close() noexcept;
+
+    static bool Write(const std::string& cachePath , uint64_t sourceHash , std::span<const std::byte> vertices , uint32_t vertexStride
+        , std::span<const uint32_t> indices);
+
+    template<typename VertexType , typename LoadSource>
+    bool Load(const std::string& sourcePath , bool isTriangleStrip , LoadSource&& loadSource);
+
+    // -- Getters --
+    template<typename VertexType>
+    std::span<const VertexType> GetVertices() const noexcept;
+    std::span<const uint32_t> GetIndices() const noexcept;
+
+private:
+
+    // ---- Data members ----
+    MappedFile m_File;
+    const MeshCacheHeader* m_pHeader{nullptr};
+};
+
+uint64_t HashFile(const std::string& filePath);
+std::string GetMeshCachePath(const std::string& sourcePath);
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// ---- Functionality ----
+
+/// @brief map the cache of a source mesh file, rebuild it first when it is missing or its source changed
+/// @brief a rebuild optimizes the buffers with OptimizeMesh before writing them, the cached indices are always a triangle list
+/// @param sourcePath the mesh file the cache belongs to, the cache sits next to it
+/// @param isTriangleStrip true if loadSource hands out a triangle strip
+/// @param loadSource bool(std::vector<VertexType>& , std::vector<uint32_t>&), parses the source file, only called to rebuild
+/// @return false when the source can't be read or loaded or the cache can't be written
+template<typename VertexType , typename LoadSource>
+bool MeshCache::Load(const std::string& sourcePath , bool isTriangleStrip , LoadSource&& loadSource)
+{
+    static_assert(std::is_trivially_copyable_v<VertexType> , "the vertices are mapped straight from the file");
+
+    const uint64_t sourceHash = HashFile(sourcePath);
+    if(sourceHash == 0) return false;
+
+    const std::string cachePath = GetMeshCachePath(sourcePath);
+    if(Open(cachePath , sourceHash , sizeof(VertexType))) return true;
+
+    std::vector<VertexType> vertices;
+    std::vector<uint32_t> indices;
+    if(!loadSource(vertices , indices)) return false;
+
+    //vertex cache and overdraw order, then the vertices in fetch order, paid once per source change
+    software::OptimizeMesh(vertices , indices , isTriangleStrip , true);
+
+    //the views point into the mapping, a cache that can't be written has nothing to hand out
+    if(!Write(cachePath , sourceHash , std::as_bytes(std::span<const VertexType>{vertices}) , sizeof(VertexType) , indices)) return false;
+    return Open(cachePath , sourceHash , sizeof(VertexType));
+}
+
+// -- Getters --
+inline std::span<const std::byte> MappedFile::GetData() const noexcept
+{
+    return std::span<const std::byte>{m_pData , m_Size};
+}
+
+template<typename VertexType>
+std::span<const VertexType> MeshCache::GetVertices() const noexcept
+{
+    if(!m_pHeader || m_pHeader->vertexStride != sizeof(VertexType)) return {};
+
+    const std::byte* const pVertices = m_File.GetData().data() + m_pHeader->vertexOffset;
+    return std::span<const VertexType>{reinterpret_cast<const VertexType*>(pVertices) , static_cast<size_t>(m_pHeader->vertexCount)};
+}
+
+inline std::span<const uint32_t> MeshCache::GetIndices() const noexcept
+{
+    if(!m_pHeader) return {};
+
+    const std::byte* const pIndices = m_File.GetData().data() + m_pHeader->indexOffset;
+    return std::span<const uint32_t>{reinterpret_cast<const uint32_t*>(pIndices) , static_cast<size_t>(m_pHeader->indexCount)};
+}
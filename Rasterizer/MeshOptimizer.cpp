@@ -0,0 +1,307 @@
+#include "MeshOptimizer.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    //the scoring of Forsyth's linear speed vertex cache optimization, tuned for an lru cache of 32 entries
+    constexpr uint32_t ForsythCacheSize{32};
+    constexpr float ForsythCacheDecayPower{1.5f};
+    constexpr float ForsythLastTriangleScore{0.75f};
+    constexpr float ForsythValenceBoostScale{2.0f};
+    constexpr float ForsythValenceBoostPower{0.5f};
+
+    /// @brief how much drawing a triangle with this vertex next is worth
+    /// @param cachePosition position in the simulated lru cache, -1 when not in it
+    /// @param remainingTriangles triangles of the vertex that weren't drawn yet
+    float GetForsythVertexScore(int cachePosition , uint32_t remainingTriangles) noexcept
+    {
+        //no triangles left, the vertex doesn't matter anymore
+        if(remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if(cachePosition >= 0)
+        {
+            //the vertices of the last triangle get a fixed score, so the order within it doesn't matter
+            if(cachePosition < 3)
+            {
+                score = ForsythLastTriangleScore;
+            }
+            else
+            {
+                const float scaler = 1.0f / static_cast<float>(ForsythCacheSize - 3);
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler , ForsythCacheDecayPower);
+            }
+        }
+
+        //vertices with few triangles left get finished first, so they don't become lone triangles later
+        score += ForsythValenceBoostScale * std::pow(static_cast<float>(remainingTriangles) , -ForsythValenceBoostPower);
+        return score;
+    }
+
+    Elite::FVector3 GetStreamPosition(const software::ObjectVertexStreams& streams , uint32_t index) noexcept
+    {
+        return Elite::FVector3{streams.positionX[index] , streams.positionY[index] , streams.positionZ[index]};
+    }
+}
+
+namespace software
+{
+    /// @brief turn a triangle strip into a triangle list, with the winding of every odd triangle flipped like BuildMeshlets does
+    /// @param strip the indices of the strip
+    /// @return 3 indices per triangle, the degenerate triangles that join strips are dropped
+    std::vector<uint32_t> ConvertTriangleStripToList(std::span<const uint32_t> strip)
+    {
+        std::vector<uint32_t> list;
+        if(strip.size() < 3) return list;
+
+        list.reserve((strip.size() - 2) * 3);
+        for(size_t i = 0; i + 2 < strip.size(); ++i)
+        {
+            const size_t evenIndex = i % 2;
+            const uint32_t triangle[3]{strip[i] , strip[i + 1 + evenIndex] , strip[i + 2 - evenIndex]};
+            if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) continue;
+
+            list.insert(list.end() , std::begin(triangle) , std::end(triangle));
+        }
+        return list;
+    }
+
+    /// @brief simulate a fifo post transform cache over a triangle list
+    /// @param indices 3 per triangle
+    /// @param vertexCount the amount of vertices the indices refer to
+    /// @param cacheSize the amount of entries of the cache
+    /// @return the average amount of vertex transforms per triangle, 0.5 is the best a regular grid can do and 3 the worst
+    float GetAverageCacheMissRatio(std::span<const uint32_t> indices , size_t vertexCount , uint32_t cacheSize)
+    {
+        if(indices.size() < 3) return 0.0f;
+
+        //the time stamp a vertex entered the cache, it is still in when less than cacheSize misses happened since
+        std::vector<uint32_t> cacheTimeStamps(vertexCount , 0);
+        uint32_t missCount = 0;
+        for(uint32_t index : indices)
+        {
+            if(cacheTimeStamps[index] != 0 && missCount - cacheTimeStamps[index] < cacheSize) continue;
+
+            ++missCount;
+            cacheTimeStamps[index] = missCount;
+        }
+        return static_cast<float>(missCount) / static_cast<float>(indices.size() / 3);
+    }
+
+    /// @brief reorder the triangles of a list for the locality of their vertices, with Forsyth's linear speed vertex cache optimization
+    /// @brief every step draws the triangle with the best score among the triangles of the vertices in a simulated lru cache
+    /// @brief this is what keeps the meshlets small, consecutive triangles sharing vertices means less duplicated vertices
+    /// @param indices 3 per triangle, reordered in place
+    /// @param vertexCount the amount of vertices the indices refer to
+    void OptimizeVertexCache(std::span<uint32_t> indices , size_t vertexCount)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if(triangleCount < 2) return;
+
+        //the triangles of every vertex, the ones still to draw at the front of its range
+        std::vector<uint32_t> triangleOffsets(vertexCount + 1 , 0);
+        for(uint32_t index : indices) ++triangleOffsets[index + 1];
+        std::partial_sum(triangleOffsets.begin() , triangleOffsets.end() , triangleOffsets.begin());
+
+        std::vector<uint32_t> remainingTriangles(vertexCount , 0);
+        std::vector<uint32_t> vertexTriangles(indices.size());
+        for(size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            for(size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                vertexTriangles[triangleOffsets[vertex] + remainingTriangles[vertex]++] = static_cast<uint32_t>(triangle);
+            }
+        }
+
+        std::vector<int> cachePositions(vertexCount , -1);
+        std::vector<float> vertexScores(vertexCount);
+        for(size_t vertex = 0; vertex < vertexCount; ++vertex) vertexScores[vertex] = GetForsythVertexScore(-1 , remainingTriangles[vertex]);
+
+        std::vector<float> triangleScores(triangleCount);
+        for(size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            triangleScores[triangle] = vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]]
+                + vertexScores[indices[triangle * 3 + 2]];
+        }
+
+        std::vector<uint8_t> isTriangleDrawn(triangleCount , 0);
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        //the cache can hold the 3 vertices of the new triangle on top of a full cache, the ones past the size are dropped
+        uint32_t cache[ForsythCacheSize + 3];
+        uint32_t newCache[ForsythCacheSize + 3];
+        uint32_t cacheCount = 0;
+
+        size_t scanTriangle = 0; //no triangle before it is left to draw, for when the cache has none
+        int64_t bestTriangle = -1;
+        while(output.size() < indices.size())
+        {
+            //the cache has no triangles left to draw, start anywhere
+            if(bestTriangle < 0)
+            {
+                while(isTriangleDrawn[scanTriangle]) ++scanTriangle;
+                bestTriangle = static_cast<int64_t>(scanTriangle);
+            }
+
+            const uint32_t* const pTriangle = &indices[size_t(bestTriangle) * 3];
+            output.insert(output.end() , pTriangle , pTriangle + 3);
+            isTriangleDrawn[size_t(bestTriangle)] = 1;
+
+            //the triangle isn't to draw anymore for its vertices, move it past their remaining triangles
+            for(size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = pTriangle[corner];
+                uint32_t* const pTriangles = &vertexTriangles[triangleOffsets[vertex]];
+                uint32_t* const pLast = pTriangles + --remainingTriangles[vertex];
+                std::iter_swap(std::find(pTriangles , pLast + 1 , static_cast<uint32_t>(bestTriangle)) , pLast);
+            }
+
+            //the vertices of the triangle move to the front of the lru cache
+            uint32_t newCacheCount = 0;
+            for(size_t corner = 0; corner < 3; ++corner) newCache[newCacheCount++] = pTriangle[corner];
+            for(uint32_t i = 0; i < cacheCount; ++i)
+            {
+                if(cache[i] != pTriangle[0] && cache[i] != pTriangle[1] && cache[i] != pTriangle[2]) newCache[newCacheCount++] = cache[i];
+            }
+
+            //rescore the vertices in the cache and the ones that fell out, then their triangles
+            for(uint32_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                cachePositions[vertex] = (i < ForsythCacheSize) ? static_cast<int>(i) : -1;
+                vertexScores[vertex] = GetForsythVertexScore(cachePositions[vertex] , remainingTriangles[vertex]);
+            }
+
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+            for(uint32_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                for(uint32_t t = 0; t < remainingTriangles[vertex]; ++t)
+                {
+                    const uint32_t triangle = vertexTriangles[triangleOffsets[vertex] + t];
+                    const float score = vertexScores[indices[size_t(triangle) * 3]] + vertexScores[indices[size_t(triangle) * 3 + 1]]
+                        + vertexScores[indices[size_t(triangle) * 3 + 2]];
+                    triangleScores[triangle] = score;
+                    if(score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+
+            cacheCount = std::min(newCacheCount , ForsythCacheSize);
+            std::copy(newCache , newCache + cacheCount , cache);
+        }
+
+        std::copy(output.begin() , output.end() , indices.begin());
+    }
+
+    /// @brief reorder clusters of triangles so the ones facing out of the mesh come first, they hide the rest from most views
+    /// @brief the clusters split where the fifo cache has none of the vertices of a triangle, reordering there costs no transforms
+    /// @brief (Sander et al., fast triangle reordering for vertex locality and reduced overdraw), run it after OptimizeVertexCache
+    /// @param indices 3 per triangle, reordered in place
+    /// @param objectStreams the object space streams of the mesh, for the positions
+    void OptimizeOverdraw(std::span<uint32_t> indices , const ObjectVertexStreams& objectStreams)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if(triangleCount < 2) return;
+
+        //cluster boundaries, at the triangles that miss the cache with all 3 vertices
+        std::vector<uint32_t> clusterStarts;
+        std::vector<uint32_t> cacheTimeStamps(objectStreams.vertexCount , 0);
+        uint32_t missCount = 0;
+        for(size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            uint32_t triangleMisses = 0;
+            for(size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t index = indices[triangle * 3 + corner];
+                if(cacheTimeStamps[index] != 0 && missCount - cacheTimeStamps[index] < CacheMissRatioCacheSize) continue;
+
+                ++missCount;
+                ++triangleMisses;
+                cacheTimeStamps[index] = missCount;
+            }
+            if(triangle == 0 || triangleMisses == 3) clusterStarts.push_back(static_cast<uint32_t>(triangle));
+        }
+        if(clusterStarts.size() < 2) return;
+        clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        //area weighted center and normal of every cluster and of the whole mesh
+        const size_t clusterCount = clusterStarts.size() - 1;
+        std::vector<Elite::FVector3> clusterCenters(clusterCount , Elite::FVector3{0.0f , 0.0f , 0.0f});
+        std::vector<Elite::FVector3> clusterNormals(clusterCount , Elite::FVector3{0.0f , 0.0f , 0.0f});
+        Elite::FVector3 meshCenter{0.0f , 0.0f , 0.0f};
+        float meshArea = 0.0f;
+        for(size_t cluster = 0; cluster < clusterCount; ++cluster)
+        {
+            float clusterArea = 0.0f;
+            for(uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+            {
+                const Elite::FVector3 position0 = GetStreamPosition(objectStreams , indices[size_t(triangle) * 3]);
+                const Elite::FVector3 position1 = GetStreamPosition(objectStreams , indices[size_t(triangle) * 3 + 1]);
+                const Elite::FVector3 position2 = GetStreamPosition(objectStreams , indices[size_t(triangle) * 3 + 2]);
+
+                const Elite::FVector3 normal = Elite::Cross(position1 - position0 , position2 - position0);
+                const float area = std::sqrt(Elite::Dot(normal , normal));
+                const Elite::FVector3 center = (position0 + position1 + position2) * (1.0f / 3.0f);
+
+                clusterCenters[cluster] = clusterCenters[cluster] + center * area;
+                clusterNormals[cluster] = clusterNormals[cluster] + normal;
+                clusterArea += area;
+            }
+
+            meshCenter = meshCenter + clusterCenters[cluster];
+            meshArea += clusterArea;
+            if(clusterArea > 0.0f) clusterCenters[cluster] = clusterCenters[cluster] * (1.0f / clusterArea);
+        }
+        if(meshArea > 0.0f) meshCenter = meshCenter * (1.0f / meshArea);
+
+        //how far out of the mesh a cluster faces, the clusters on the outside first
+        std::vector<float> clusterSortKeys(clusterCount);
+        for(size_t cluster = 0; cluster < clusterCount; ++cluster)
+        {
+            const Elite::FVector3& normal = clusterNormals[cluster];
+            const float normalLength = std::sqrt(Elite::Dot(normal , normal));
+            clusterSortKeys[cluster] = (normalLength > 0.0f) ? Elite::Dot(clusterCenters[cluster] - meshCenter , normal) / normalLength : 0.0f;
+        }
+
+        std::vector<uint32_t> clusterOrder(clusterCount);
+        std::iota(clusterOrder.begin() , clusterOrder.end() , 0u);
+        std::stable_sort(clusterOrder.begin() , clusterOrder.end()
+            , [&clusterSortKeys](uint32_t a , uint32_t b) { return clusterSortKeys[a] > clusterSortKeys[b]; });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for(uint32_t cluster : clusterOrder)
+        {
+            output.insert(output.end() , indices.begin() + size_t(clusterStarts[cluster]) * 3 , indices.begin() + size_t(clusterStarts[cluster + 1]) * 3);
+        }
+        std::copy(output.begin() , output.end() , indices.begin());
+    }
+
+    /// @brief number the vertices in the order the index buffer first uses them
+    /// @param indices the index buffer
+    /// @param vertexCount the amount of vertices the indices refer to
+    /// @param remap output, the new index of every vertex, UINT32_MAX for a vertex no triangle uses
+    /// @return the amount of used vertices
+    size_t BuildVertexFetchRemap(std::span<const uint32_t> indices , size_t vertexCount , std::vector<uint32_t>& remap)
+    {
+        remap.assign(vertexCount , UINT32_MAX);
+
+        uint32_t nextVertex = 0;
+        for(uint32_t index : indices)
+        {
+            if(remap[index] == UINT32_MAX) remap[index] = nextVertex++;
+        }
+        return nextVertex;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// - Project includes -
+#include "VertexStreams.h"
+
+namespace software
+{
+    /// @brief the effect of OptimizeMesh, the cache miss ratio is in vertex transforms per triangle with a 16 entry fifo cache
+    struct MeshOptimizationStats
+    {
+        float cacheMissRatioBefore;
+        float cacheMissRatioAfter;
+        size_t triangleCount;
+        size_t vertexCountBefore;
+        size_t vertexCountAfter; //vertices no triangle uses are dropped
+    };
+
+    /// @brief size of the fifo cache GetAverageCacheMissRatio simulates
+    constexpr uint32_t CacheMissRatioCacheSize{16};
+
+    std::vector<uint32_t> ConvertTriangleStripToList(std::span<const uint32_t> strip);
+    float GetAverageCacheMissRatio(std::span<const uint32_t> indices , size_t vertexCount , uint32_t cacheSize = CacheMissRatioCacheSize);
+
+    void OptimizeVertexCache(std::span<uint32_t> indices , size_t vertexCount);
+    void OptimizeOverdraw(std::span<uint32_t> indices , const ObjectVertexStreams& objectStreams);
+    size_t BuildVertexFetchRemap(std::span<const uint32_t> indices , size_t vertexCount , std::vector<uint32_t>& remap);
+
+    template<typename VertexType>
+    size_t OptimizeVertexFetch(std::span<uint32_t> indices , std::vector<VertexType>& vertices);
+    template<typename VertexType>
+    MeshOptimizationStats OptimizeMesh(std::vector<VertexType>& vertices , std::vector<uint32_t>& indices , bool isTriangleStrip
+        , bool optimizeOverdraw);
+
+    // =============================================================================
+    //                               Inline Definitions
+    // =============================================================================
+
+    /// @brief put the vertices in the order the index buffer first uses them, so the vertex stage reads them front to back
+    /// @param indices the index buffer, remapped in place
+    /// @param vertices the vertex buffer, reordered, vertices no triangle uses are dropped
+    /// @return the new amount of vertices
+    template<typename VertexType>
+    size_t OptimizeVertexFetch(std::span<uint32_t> indices , std::vector<VertexType>& vertices)
+    {
+        std::vector<uint32_t> remap;
+        const size_t usedCount = BuildVertexFetchRemap(indices , vertices.size() , remap);
+
+        std::vector<VertexType> reordered(usedCount);
+        for(size_t vertex = 0; vertex < vertices.size(); ++vertex)
+        {
+            if(remap[vertex] != UINT32_MAX) reordered[remap[vertex]] = vertices[vertex];
+        }
+        for(uint32_t& index : indices) index = remap[index];
+
+        vertices.swap(reordered);
+        return usedCount;
+    }
+
+    /// @brief the load time optimization of a mesh: triangles in vertex cache order, optionally clusters in overdraw order, then
+    /// @brief the vertices in fetch order
+    /// @brief a strip comes out as a triangle list, the primitive has to be switched to PrimitiveTopology::TriangleList
+    /// @param vertices the vertex buffer, any vertex with a position, normal, tangent and uv
+    /// @param indices the index buffer, replaced by the optimized triangle list
+    /// @param isTriangleStrip true if indices is a strip
+    /// @param optimizeOverdraw true to sort the clusters of triangles front to back, costs a little of the vertex cache gain
+    /// @return the cache miss ratio before and after
+    template<typename VertexType>
+    MeshOptimizationStats OptimizeMesh(std::vector<VertexType>& vertices , std::vector<uint32_t>& indices , bool isTriangleStrip
+        , bool optimizeOverdraw)
+    {
+        if(isTriangleStrip) indices = ConvertTriangleStripToList(indices);
+
+        MeshOptimizationStats stats{};
+        stats.triangleCount = indices.size() / 3;
+        stats.vertexCountBefore = vertices.size();
+        stats.cacheMissRatioBefore = GetAverageCacheMissRatio(indices , vertices.size());
+
+        OptimizeVertexCache(indices , vertices.size());
+        if(optimizeOverdraw)
+        {
+            ObjectVertexStreams objectStreams;
+            BuildObjectVertexStreams(vertices , objectStreams);
+            OptimizeOverdraw(indices , objectStreams);
+        }
+        stats.vertexCountAfter = OptimizeVertexFetch(std::span<uint32_t>{indices} , vertices);
+        stats.cacheMissRatioAfter = GetAverageCacheMissRatio(indices , vertices.size());
+        return stats;
+    }
+}
@@ -0,0 +1,250 @@
+#include "Meshlet.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    /// @brief the mesh vertex of every local vertex and the triangles of the meshlet that is being filled
+    struct MeshletBuilder
+    {
+        std::vector<uint32_t> vertices;
+        std::vector<uint8_t> localIndices;
+    };
+
+    Elite::FVector3 GetStreamPosition(const software::ObjectVertexStreams& streams , uint32_t index) noexcept
+    {
+        return Elite::FVector3{streams.positionX[index] , streams.positionY[index] , streams.positionZ[index]};
+    }
+
+    /// @brief copy a vertex to the end of the meshlet streams
+    void AppendVertex(const software::ObjectVertexStreams& source , uint32_t index , software::ObjectVertexStreams& streams)
+    {
+        streams.positionX.push_back(source.positionX[index]);
+        streams.positionY.push_back(source.positionY[index]);
+        streams.positionZ.push_back(source.positionZ[index]);
+        streams.normalX.push_back(source.normalX[index]);
+        streams.normalY.push_back(source.normalY[index]);
+        streams.normalZ.push_back(source.normalZ[index]);
+        streams.tangentX.push_back(source.tangentX[index]);
+        streams.tangentY.push_back(source.tangentY[index]);
+        streams.tangentZ.push_back(source.tangentZ[index]);
+        streams.u.push_back(source.u[index]);
+        streams.v.push_back(source.v[index]);
+    }
+
+    /// @brief move the filled meshlet to the mesh, its vertices padded to a whole amount of batches
+    void FlushMeshlet(const software::ObjectVertexStreams& source , MeshletBuilder& builder , software::MeshletMesh& meshletMesh)
+    {
+        if(builder.localIndices.empty()) return;
+
+        software::ObjectVertexStreams& streams = meshletMesh.streams;
+
+        software::Meshlet meshlet{};
+        meshlet.vertexOffset = static_cast<uint32_t>(streams.positionX.size());
+        meshlet.vertexCount = static_cast<uint32_t>(builder.vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(meshletMesh.localIndices.size() / 3);
+        meshlet.triangleCount = static_cast<uint32_t>(builder.localIndices.size() / 3);
+
+        for(uint32_t vertex : builder.vertices) AppendVertex(source , vertex , streams);
+
+        //padding lanes get a valid normal, tangent and depth so they don't divide by 0
+        while(streams.positionX.size() % software::VertexBatchSize != 0)
+        {
+            AppendVertex(source , builder.vertices.front() , streams);
+            streams.normalX.back() = 0.0f;
+            streams.normalY.back() = 0.0f;
+            streams.normalZ.back() = 1.0f;
+            streams.tangentX.back() = 1.0f;
+            streams.tangentY.back() = 0.0f;
+            streams.tangentZ.back() = 0.0f;
+        }
+        streams.vertexCount = streams.positionX.size();
+
+        //bounding sphere around the center of the box of the vertices
+        Elite::FVector3 boundsMin = GetStreamPosition(source , builder.vertices.front());
+        Elite::FVector3 boundsMax = boundsMin;
+        for(uint32_t vertex : builder.vertices)
+        {
+            const Elite::FVector3 position = GetStreamPosition(source , vertex);
+            boundsMin = Elite::FVector3{std::min(boundsMin.x , position.x) , std::min(boundsMin.y , position.y) , std::min(boundsMin.z , position.z)};
+            boundsMax = Elite::FVector3{std::max(boundsMax.x , position.x) , std::max(boundsMax.y , position.y) , std::max(boundsMax.z , position.z)};
+        }
+        const Elite::FVector3 center = (boundsMin + boundsMax) * 0.5f;
+
+        float radiusSquared = 0.0f;
+        for(uint32_t vertex : builder.vertices)
+        {
+            const Elite::FVector3 offset = GetStreamPosition(source , vertex) - center;
+            radiusSquared = std::max(radiusSquared , Elite::Dot(offset , offset));
+        }
+        meshlet.center = Elite::FPoint3{center.x , center.y , center.z};
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        //normal cone, the axis is the average of the triangle normals and the cutoff comes from the widest normal
+        std::vector<Elite::FVector3> normals;
+        normals.reserve(meshlet.triangleCount);
+        Elite::FVector3 normalSum{0.0f , 0.0f , 0.0f};
+        for(size_t i = 0; i < builder.localIndices.size(); i += 3)
+        {
+            const Elite::FVector3 position0 = GetStreamPosition(source , builder.vertices[builder.localIndices[i]]);
+            const Elite::FVector3 position1 = GetStreamPosition(source , builder.vertices[builder.localIndices[i + 1]]);
+            const Elite::FVector3 position2 = GetStreamPosition(source , builder.vertices[builder.localIndices[i + 2]]);
+
+            const Elite::FVector3 normal = Elite::Cross(position1 - position0 , position2 - position0);
+            const float length = std::sqrt(Elite::Dot(normal , normal));
+            if(length <= 0.0f) continue;
+
+            normals.push_back(normal * (1.0f / length));
+            normalSum = normalSum + normals.back();
+        }
+
+        meshlet.coneAxis = Elite::FVector3{0.0f , 0.0f , 1.0f};
+        meshlet.coneCutoff = 1.0f;
+
+        const float normalSumLength = std::sqrt(Elite::Dot(normalSum , normalSum));
+        if(normalSumLength > 0.0f)
+        {
+            meshlet.coneAxis = normalSum * (1.0f / normalSumLength);
+
+            float minimumDot = 1.0f;
+            for(const Elite::FVector3& normal : normals) minimumDot = std::min(minimumDot , Elite::Dot(normal , meshlet.coneAxis));
+
+            //a cone wider than about 84 degrees rejects almost nothing, keep the cutoff at 1 so it is never tested
+            if(minimumDot > 0.1f) meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+        }
+
+        meshletMesh.localIndices.insert(meshletMesh.localIndices.end() , builder.localIndices.begin() , builder.localIndices.end());
+        meshletMesh.meshlets.push_back(meshlet);
+
+        builder.vertices.clear();
+        builder.localIndices.clear();
+    }
+}
+
+namespace software
+{
+    /// @brief split a mesh into meshlets of at most 64 vertices and 124 triangles, in the order of the index buffer
+    /// @brief a triangle goes into the current meshlet until its vertices or triangles are full
+    /// @param objectStreams the object space streams of the mesh
+    /// @param indices the index buffer of the mesh
+    /// @param isTriangleStrip true for a strip, the winding of every odd triangle gets flipped like in the geometry stage
+    /// @param meshletMesh output
+    void BuildMeshlets(const ObjectVertexStreams& objectStreams , std::span<const uint32_t> indices , bool isTriangleStrip
+        , MeshletMesh& meshletMesh)
+    {
+        meshletMesh = MeshletMesh{};
+        if(indices.size() < 3) return;
+
+        //local index of every mesh vertex in the current meshlet, valid when its meshlet matches
+        constexpr uint32_t noMeshlet = 0xFFFFFFFF;
+        std::vector<uint32_t> vertexMeshlet(objectStreams.vertexCount , noMeshlet);
+        std::vector<uint8_t> vertexLocalIndex(objectStreams.vertexCount , 0);
+
+        MeshletBuilder builder;
+        builder.vertices.reserve(MaxMeshletVertices);
+        builder.localIndices.reserve(MaxMeshletTriangles * 3);
+
+        const size_t triangleCount = isTriangleStrip ? indices.size() - 2 : indices.size() / 3;
+        for(size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const size_t i = isTriangleStrip ? triangle : triangle * 3;
+            const size_t evenIndex = isTriangleStrip ? (i % 2) : 0;
+            const uint32_t triangleIndices[3]{indices[i] , indices[i + 1 + evenIndex] , indices[i + 2 - evenIndex]};
+
+            //degenerate triangles of strips never get rasterized
+            if(triangleIndices[0] == triangleIndices[1] || triangleIndices[1] == triangleIndices[2] || triangleIndices[0] == triangleIndices[2]) continue;
+
+            const uint32_t currentMeshlet = static_cast<uint32_t>(meshletMesh.meshlets.size());
+            uint32_t newVertexCount = 0;
+            for(uint32_t index : triangleIndices) newVertexCount += (vertexMeshlet[index] != currentMeshlet) ? 1 : 0;
+
+            if(builder.vertices.size() + newVertexCount > MaxMeshletVertices || builder.localIndices.size() / 3 >= MaxMeshletTriangles)
+            {
+                FlushMeshlet(objectStreams , builder , meshletMesh);
+            }
+
+            //flushing started a new meshlet
+            const uint32_t meshletIndex = static_cast<uint32_t>(meshletMesh.meshlets.size());
+            for(uint32_t index : triangleIndices)
+            {
+                if(vertexMeshlet[index] != meshletIndex)
+                {
+                    vertexMeshlet[index] = meshletIndex;
+                    vertexLocalIndex[index] = static_cast<uint8_t>(builder.vertices.size());
+                    builder.vertices.push_back(index);
+                }
+                builder.localIndices.push_back(vertexLocalIndex[index]);
+            }
+        }
+        FlushMeshlet(objectStreams , builder , meshletMesh);
+
+        //a sphere around the spheres of the meshlets, centered on their bounding box
+        float boundsMin[3]{FLT_MAX , FLT_MAX , FLT_MAX};
+        float boundsMax[3]{-FLT_MAX , -FLT_MAX , -FLT_MAX};
+        for(const Meshlet& meshlet : meshletMesh.meshlets)
+        {
+            const float center[3]{meshlet.center.x , meshlet.center.y , meshlet.center.z};
+            for(int axis = 0; axis < 3; ++axis)
+            {
+                boundsMin[axis] = std::min(boundsMin[axis] , center[axis] - meshlet.radius);
+                boundsMax[axis] = std::max(boundsMax[axis] , center[axis] + meshlet.radius);
+            }
+        }
+
+        meshletMesh.center = Elite::FPoint3{(boundsMin[0] + boundsMax[0]) * 0.5f , (boundsMin[1] + boundsMax[1]) * 0.5f , (boundsMin[2] + boundsMax[2]) * 0.5f};
+        meshletMesh.radius = 0.0f;
+        for(const Meshlet& meshlet : meshletMesh.meshlets)
+        {
+            const Elite::FVector3 offset{meshlet.center.x - meshletMesh.center.x , meshlet.center.y - meshletMesh.center.y
+                , meshlet.center.z - meshletMesh.center.z};
+            meshletMesh.radius = std::max(meshletMesh.radius , std::sqrt(Elite::Dot(offset , offset)) + meshlet.radius);
+        }
+    }
+
+    /// @brief test the bounding sphere of a meshlet against the planes of the frustum
+    /// @param meshlet the meshlet to test
+    /// @param planes normalized frustum planes in the object space of the meshlet
+    /// @return true if the sphere is completely outside one of the planes
+    bool GetIsMeshletOutsideFrustum(const Meshlet& meshlet , const FrustumPlane (&planes)[6]) noexcept
+    {
+        for(const FrustumPlane& plane : planes)
+        {
+            if(plane.a * meshlet.center.x + plane.b * meshlet.center.y + plane.c * meshlet.center.z + plane.d < -meshlet.radius) return true;
+        }
+        return false;
+    }
+
+    /// @brief test the bounding sphere of a whole mesh against the planes of the frustum, before any of its meshlets
+    /// @param meshletMesh the meshlets of the mesh
+    /// @param planes normalized frustum planes in the object space of the mesh
+    /// @return true if the sphere is completely outside one of the planes
+    bool GetIsMeshOutsideFrustum(const MeshletMesh& meshletMesh , const FrustumPlane (&planes)[6]) noexcept
+    {
+        for(const FrustumPlane& plane : planes)
+        {
+            if(plane.a * meshletMesh.center.x + plane.b * meshletMesh.center.y + plane.c * meshletMesh.center.z + plane.d < -meshletMesh.radius) return true;
+        }
+        return false;
+    }
+
+    /// @brief check if the camera is on the same side of every triangle of a meshlet with its normal cone and bounding sphere
+    /// @param meshlet the meshlet to test
+    /// @param cameraPosition the camera in the object space of the meshlet
+    /// @return Front or Back when every triangle faces the camera the same way, Mixed when it can't be told
+    MeshletFacing GetMeshletFacing(const Meshlet& meshlet , const Elite::FPoint3& cameraPosition) noexcept
+    {
+        if(meshlet.coneCutoff >= 1.0f) return MeshletFacing::Mixed;
+
+        const Elite::FVector3 toMeshlet{meshlet.center.x - cameraPosition.x , meshlet.center.y - cameraPosition.y , meshlet.center.z - cameraPosition.z};
+        const float distance = std::sqrt(Elite::Dot(toMeshlet , toMeshlet));
+        const float axisDistance = Elite::Dot(toMeshlet , meshlet.coneAxis);
+        const float margin = meshlet.coneCutoff * distance + meshlet.radius;
+
+        if(axisDistance >= margin) return MeshletFacing::Back;
+        if(-axisDistance >= margin) return MeshletFacing::Front;
+        return MeshletFacing::Mixed;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "Frustum.h"
+#include "VertexStreams.h"
+
+namespace software
+{
+    constexpr uint32_t MaxMeshletVertices{64};
+    constexpr uint32_t MaxMeshletTriangles{124};
+
+    /// @brief a small cluster of triangles of a mesh with the bounds to cull it as a whole, everything in object space
+    struct Meshlet
+    {
+        uint32_t vertexOffset; //first vertex in the meshlet streams, multiple of VertexBatchSize
+        uint32_t vertexCount;
+        uint32_t triangleOffset; //first triangle in the local index buffer
+        uint32_t triangleCount;
+
+        Elite::FPoint3 center; //bounding sphere
+        float radius;
+        Elite::FVector3 coneAxis; //average normal of the triangles
+        float coneCutoff; //sine of the cone angle, 1 when the normals spread too far to cull on
+    };
+
+    /// @brief a mesh split into meshlets, built once per mesh
+    /// @brief every meshlet has its own range of the vertex streams, vertices shared with other meshlets are duplicated
+    struct MeshletMesh
+    {
+        ObjectVertexStreams streams;
+        std::vector<Meshlet> meshlets;
+        std::vector<uint8_t> localIndices; //3 per triangle, relative to the vertexOffset of the meshlet
+
+        Elite::FPoint3 center; //bounding sphere of all meshlets, to cull an instance of the mesh as a whole
+        float radius;
+    };
+
+    /// @brief which side of its triangles the camera is on, for the whole meshlet
+    enum class MeshletFacing
+    {
+        Mixed ,
+        Front , //in front of every triangle, the normals point to the camera
+        Back //behind every triangle
+    };
+
+    void BuildMeshlets(const ObjectVertexStreams& objectStreams , std::span<const uint32_t> indices , bool isTriangleStrip
+        , MeshletMesh& meshletMesh);
+
+    bool GetIsMeshletOutsideFrustum(const Meshlet& meshlet , const FrustumPlane (&planes)[6]) noexcept;
+    bool GetIsMeshOutsideFrustum(const MeshletMesh& meshletMesh , const FrustumPlane (&planes)[6]) noexcept;
+    MeshletFacing GetMeshletFacing(const Meshlet& meshlet , const Elite::FPoint3& cameraPosition) noexcept;
+}
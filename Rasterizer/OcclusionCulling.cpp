@@ -0,0 +1,226 @@
+#include "OcclusionCulling.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    /// @brief transform a point with w = 1 by a matrix, the result is homogeneous
+    void TransformPoint(const Elite::FMatrix4& matrix , float x , float y , float z , float (&result)[4]) noexcept
+    {
+        for(int r = 0; r < 4; ++r) result[r] = matrix(r , 0) * x + matrix(r , 1) * y + matrix(r , 2) * z + matrix(r , 3);
+    }
+}
+
+// ---- Functionality ----
+
+/// @brief build the pyramid of this frame from the captured depth of the last frame, seen with the camera of this frame
+/// @brief every cell of the last frame lands on one cell of the new grid at its far depth, cells several land on keep the farthest
+/// @brief cells nothing lands on get the farthest depth of their 4 neighbours if they all got one, else they occlude nothing
+/// @param viewProjectionMatrix projection * view of the camera of this frame
+/// @param viewport the map from ndc to the cells of this frame
+/// @param width the amount of columns of the grid of this frame
+/// @param height the amount of rows of the grid of this frame
+void OcclusionCuller::Reproject(const Elite::FMatrix4& viewProjectionMatrix , const OcclusionViewport& viewport , uint32_t width , uint32_t height)
+{
+    m_ViewProjectionMatrix = viewProjectionMatrix;
+    m_Viewport = viewport;
+    m_HasDepth = m_HasPrevious && width > 0 && height > 0;
+    if(!m_HasDepth) return;
+
+    ResizePyramid(width , height);
+    float* const pCells = m_Pyramid.data();
+    std::fill(pCells , pCells + size_t(width) * height , Unwritten);
+
+    //from the ndc of the last frame straight to the clip space of this one
+    const Elite::FMatrix4 previousToCurrent = viewProjectionMatrix * m_PreviousInverseViewProjection;
+    const float invPreviousScaleX = 1.0f / m_PreviousViewport.scaleX;
+    const float invPreviousScaleY = 1.0f / m_PreviousViewport.scaleY;
+
+    for(uint32_t y = 0; y < m_PreviousHeight; ++y)
+    {
+        const float ndcY = (static_cast<float>(y) + 0.5f - m_PreviousViewport.offsetY) * invPreviousScaleY;
+        for(uint32_t x = 0; x < m_PreviousWidth; ++x)
+        {
+            //an empty cell is moved like a point on the far plane, so it keeps the cells it lands on from occluding
+            const float previousDepth = m_PreviousDepths[size_t(y) * m_PreviousWidth + x];
+            const bool isEmpty = previousDepth == FLT_MAX;
+            const float ndcX = (static_cast<float>(x) + 0.5f - m_PreviousViewport.offsetX) * invPreviousScaleX;
+
+            float clip[4];
+            TransformPoint(previousToCurrent , ndcX , ndcY , isEmpty ? 1.0f : previousDepth , clip);
+            if(clip[3] <= 0.0f) continue;
+
+            const float invW = 1.0f / clip[3];
+            const float cellX = std::floor(clip[0] * invW * viewport.scaleX + viewport.offsetX);
+            const float cellY = std::floor(clip[1] * invW * viewport.scaleY + viewport.offsetY);
+            if(cellX < 0.0f || cellY < 0.0f || cellX >= static_cast<float>(width) || cellY >= static_cast<float>(height)) continue;
+
+            //a surface that came in front of the near plane gets clipped, it hides nothing anymore
+            const float depth = clip[2] * invW;
+            float& cell = pCells[static_cast<size_t>(cellY) * width + static_cast<size_t>(cellX)];
+            cell = std::max(cell , (isEmpty || depth < 0.0f) ? FLT_MAX : depth);
+        }
+    }
+
+    //the camera moving closer spreads the cells apart, fill the single cell holes that leaves
+    for(uint32_t y = 0; y < height; ++y)
+    {
+        for(uint32_t x = 0; x < width; ++x)
+        {
+            float& cell = pCells[size_t(y) * width + x];
+            if(cell != Unwritten) continue;
+
+            cell = FLT_MAX;
+            if(x == 0 || y == 0 || x + 1 == width || y + 1 == height) continue;
+
+            const size_t index = size_t(y) * width + x;
+            const float neighbours[4]{pCells[index - 1] , pCells[index + 1] , pCells[index - width] , pCells[index + width]};
+            if(std::find(neighbours , neighbours + 4 , Unwritten) != neighbours + 4) continue;
+            cell = *std::max_element(neighbours , neighbours + 4);
+        }
+    }
+
+    BuildPyramid();
+}
+
+/// @brief keep the farthest depths of the frame that was just drawn, to reproject them next frame
+/// @brief the pyramid gets built from them as they are, so the primitives culled this frame can be tested against what was really drawn
+/// @param farDepths the farthest depth per cell, FLT_MAX where nothing was drawn
+/// @param width the amount of columns of the grid
+/// @param height the amount of rows of the grid
+/// @param viewProjectionMatrix projection * view of the camera the depths were drawn with
+/// @param viewport the map from ndc to the cells of the grid
+void OcclusionCuller::Capture(std::span<const float> farDepths , uint32_t width , uint32_t height , const Elite::FMatrix4& viewProjectionMatrix
+    , const OcclusionViewport& viewport)
+{
+    m_PreviousDepths.assign(farDepths.begin() , farDepths.end());
+    m_PreviousWidth = width;
+    m_PreviousHeight = height;
+    m_PreviousInverseViewProjection = Elite::Inverse(viewProjectionMatrix);
+    m_PreviousViewport = viewport;
+    m_HasPrevious = width > 0 && height > 0;
+
+    m_ViewProjectionMatrix = viewProjectionMatrix;
+    m_Viewport = viewport;
+    m_HasDepth = m_HasPrevious;
+    if(!m_HasDepth) return;
+
+    ResizePyramid(width , height);
+    std::copy(farDepths.begin() , farDepths.end() , m_Pyramid.begin());
+    BuildPyramid();
+}
+
+/// @brief test a box against the pyramid, on the level where the box covers at most 2 x 2 cells
+/// @param worldBounds the box around the primitive in world space
+/// @return true if the box is behind the depth in every cell it covers, false when it can't be told
+bool OcclusionCuller::GetIsOccluded(const BoundingBoxWorld& worldBounds) const noexcept
+{
+    if(!m_HasDepth) return false;
+
+    float minX = FLT_MAX , minY = FLT_MAX , maxX = -FLT_MAX , maxY = -FLT_MAX;
+    float nearestDepth = FLT_MAX;
+    for(int corner = 0; corner < 8; ++corner)
+    {
+        float clip[4];
+        TransformPoint(m_ViewProjectionMatrix , (corner & 1) ? worldBounds.max.x : worldBounds.min.x
+            , (corner & 2) ? worldBounds.max.y : worldBounds.min.y , (corner & 4) ? worldBounds.max.z : worldBounds.min.z , clip);
+
+        //a box around the camera has no bounds on screen
+        if(clip[3] <= 0.0f) return false;
+
+        const float invW = 1.0f / clip[3];
+        const float cellX = clip[0] * invW * m_Viewport.scaleX + m_Viewport.offsetX;
+        const float cellY = clip[1] * invW * m_Viewport.scaleY + m_Viewport.offsetY;
+        minX = std::min(minX , cellX);
+        maxX = std::max(maxX , cellX);
+        minY = std::min(minY , cellY);
+        maxY = std::max(maxY , cellY);
+        nearestDepth = std::min(nearestDepth , clip[2] * invW);
+    }
+
+    //the part of the box off screen can't be seen
+    const Level& base = m_Levels.front();
+    int left = static_cast<int>(std::max(std::floor(minX) , 0.0f));
+    int top = static_cast<int>(std::max(std::floor(minY) , 0.0f));
+    int right = static_cast<int>(std::min(std::floor(maxX) , static_cast<float>(base.width - 1)));
+    int bottom = static_cast<int>(std::min(std::floor(maxY) , static_cast<float>(base.height - 1)));
+    if(right < left || bottom < top) return false;
+
+    size_t levelIndex = 0;
+    while(std::max(right - left , bottom - top) > 1 && levelIndex + 1 < m_Levels.size())
+    {
+        left >>= 1;
+        top >>= 1;
+        right >>= 1;
+        bottom >>= 1;
+        ++levelIndex;
+    }
+
+    const Level& level = m_Levels[levelIndex];
+    for(int y = top; y <= bottom; ++y)
+    {
+        for(int x = left; x <= right; ++x)
+        {
+            if(nearestDepth <= m_Pyramid[level.offset + size_t(y) * level.width + x]) return false;
+        }
+    }
+    return true;
+}
+
+/// @brief forget the captured depth, the next frame tests nothing as occluded
+void OcclusionCuller::Reset() noexcept
+{
+    m_HasPrevious = false;
+    m_HasDepth = false;
+}
+
+// ---- Private Functions ----
+
+/// @brief lay out the levels of a pyramid with the given base, every level halves the one below it until a single cell
+/// @param width the amount of columns of level 0
+/// @param height the amount of rows of level 0
+void OcclusionCuller::ResizePyramid(uint32_t width , uint32_t height)
+{
+    m_Levels.clear();
+    size_t cellCount = 0;
+    while(true)
+    {
+        m_Levels.push_back(Level{cellCount , width , height});
+        cellCount += size_t(width) * height;
+        if(width == 1 && height == 1) break;
+
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+
+    //only grows, a smaller internal resolution reuses the storage
+    if(m_Pyramid.size() < cellCount) m_Pyramid.resize(cellCount);
+}
+
+/// @brief fill every level above 0 with the farthest depth of the 2 x 2 cells below it, an odd edge only has 1 or 2
+void OcclusionCuller::BuildPyramid() noexcept
+{
+    for(size_t levelIndex = 1; levelIndex < m_Levels.size(); ++levelIndex)
+    {
+        const Level& below = m_Levels[levelIndex - 1];
+        const Level& level = m_Levels[levelIndex];
+        const float* const pBelow = &m_Pyramid[below.offset];
+        float* const pLevel = &m_Pyramid[level.offset];
+
+        for(uint32_t y = 0; y < level.height; ++y)
+        {
+            const uint32_t y0 = y * 2;
+            const uint32_t y1 = std::min(y0 + 1 , below.height - 1);
+            for(uint32_t x = 0; x < level.width; ++x)
+            {
+                const uint32_t x0 = x * 2;
+                const uint32_t x1 = std::min(x0 + 1 , below.width - 1);
+                pLevel[size_t(y) * level.width + x] = std::max(std::max(pBelow[size_t(y0) * below.width + x0] , pBelow[size_t(y0) * below.width + x1])
+                    , std::max(pBelow[size_t(y1) * below.width + x0] , pBelow[size_t(y1) * below.width + x1]));
+            }
+        }
+    }
+}
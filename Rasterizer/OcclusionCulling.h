@@ -0,0 +1,92 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "SceneBVH.h"
+
+/// @brief the map from ndc x and y to the cells of a depth grid, cell = ndc * scale + offset
+struct OcclusionViewport
+{
+    float scaleX;
+    float offsetX;
+    float scaleY;
+    float offsetY;
+};
+
+/// @brief Occlusion test of whole primitives against the depth of the previous frame, before their vertices get transformed
+/// @brief The farthest depth per cell of the last frame is reprojected with the camera of the new frame into a pyramid of far depths
+/// @brief A primitive is occluded when its nearest depth is behind every cell its screen bounds cover
+/// @brief Reprojection doesn't know about moved primitives, so a test can be wrong for a frame, the owner re-tests with Capture
+class OcclusionCuller final
+{
+public:
+
+      // ---- Constructors ----
+    OcclusionCuller() = default;
+
+    // ---- Destructor ----
+    ~OcclusionCuller() = default;
+
+    // ---- Copy/Move ----
+    OcclusionCuller(const OcclusionCuller& other) = delete; //copy constructor
+    OcclusionCuller(OcclusionCuller&& other) noexcept = delete; //move constructor
+    OcclusionCuller& operator=(const OcclusionCuller& other) = delete; // copy assignment
+    OcclusionCuller& operator=(OcclusionCuller&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void Reproject(const Elite::FMatrix4& viewProjectionMatrix , const OcclusionViewport& viewport , uint32_t width , uint32_t height);
+    void Capture(std::span<const float> farDepths , uint32_t width , uint32_t height , const Elite::FMatrix4& viewProjectionMatrix
+        , const OcclusionViewport& viewport);
+    bool GetIsOccluded(const BoundingBoxWorld& worldBounds) const noexcept;
+    void Reset() noexcept;
+
+    // -- Getters --
+    bool GetHasDepth() const noexcept;
+
+private:
+
+      // ---- Private Functions ----
+    void ResizePyramid(uint32_t width , uint32_t height);
+    void BuildPyramid() noexcept;
+
+    // ---- Data members ----
+    /// @brief a level of the pyramid, its cells start at offset in m_Pyramid
+    struct Level
+    {
+        size_t offset;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    static constexpr float Unwritten{-1.0f}; //cell no reprojected depth landed in, depths are never negative
+
+    //the pyramid the tests of the current frame go against, level 0 at the resolution of the grid
+    std::vector<float> m_Pyramid;
+    std::vector<Level> m_Levels;
+    Elite::FMatrix4 m_ViewProjectionMatrix{};
+    OcclusionViewport m_Viewport{};
+    bool m_HasDepth{false};
+
+    //the captured grid of the last frame, the source of the next reprojection
+    std::vector<float> m_PreviousDepths;
+    uint32_t m_PreviousWidth{0};
+    uint32_t m_PreviousHeight{0};
+    Elite::FMatrix4 m_PreviousInverseViewProjection{};
+    OcclusionViewport m_PreviousViewport{};
+    bool m_HasPrevious{false};
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// -- Getters --
+inline bool OcclusionCuller::GetHasDepth() const noexcept
+{
+    return m_HasDepth;
+}
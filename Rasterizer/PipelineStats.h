@@ -0,0 +1,104 @@
+#pragma once
+
+// - Standard includes -
+#include <chrono>
+#include <cstdint>
+
+//define to time and count the stages of the software pipeline and to record the overdraw per pixel
+//off by default, the timers sit in the raster loops and cost more than the work of small triangles
+//#define SOFTWARE_PIPELINE_STATS
+
+namespace software
+{
+    enum PipelineStage
+    {
+        StageVertexTransform ,
+        StageCulling , //outcodes and clipping
+        StageTriangleSetup , //projection, area and cull mode, edge functions
+        StageRaster , //coverage and depth test, visibility buffer writes
+        StageShading ,
+        StagePresent , //color resolve, then blit and window update on the thread of the window
+        PipelineStageCount
+    };
+
+    /// @brief counters and stage times of the software pipeline, only filled with SOFTWARE_PIPELINE_STATS
+    /// @brief raster and shading run on every worker, their times are summed over the threads
+    struct PipelineStats
+    {
+        uint64_t stageNanoseconds[PipelineStageCount];
+        uint64_t draws; //primitives that reached the vertex stage, an instanced primitive counts once
+        uint64_t primitivesFrustumCulled; //skipped by the scene bvh, before the vertex transform
+        uint64_t primitivesOcclusionCulled; //behind the reprojected depth of the previous frame, before the vertex transform
+        uint64_t primitivesOcclusionFalseNegatives; //occlusion culled but not hidden by the depth of its own frame, drawn next frame
+        uint64_t primitivesReordered; //places primitives moved in the draw order since the last frame
+        uint64_t instancesFrustumCulled; //instance of an instanced primitive with its bounding sphere outside the frustum
+        uint64_t meshletsFrustumCulled; //bounding sphere outside the frustum, before the vertex transform
+        uint64_t meshletsCullModeCulled; //normal cone facing the culled side, before the vertex transform
+        uint64_t trianglesFrustumCulled; //outside a frustum plane, clipped away or off screen
+        uint64_t trianglesDegenerate; //no area in raster space
+        uint64_t trianglesCullMode; //back or front face culled
+        uint64_t pixelsTested; //inside a triangle, went through the depth test
+        uint64_t pixelsDepthRejected; //failed the depth test
+    };
+
+    /// @brief add the time between construction and destruction to a counter
+    class ScopedStageTimer final
+    {
+    public:
+        explicit ScopedStageTimer(uint64_t& nanoseconds) noexcept
+            : m_Nanoseconds{nanoseconds}
+            , m_Start{std::chrono::steady_clock::now()}
+        {}
+
+        ~ScopedStageTimer()
+        {
+            m_Nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_Start).count());
+        }
+
+        ScopedStageTimer(const ScopedStageTimer& other) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer& other) = delete;
+
+    private:
+        uint64_t& m_Nanoseconds;
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+    /// @brief add the counters of one pipeline stats to another, to sum the tiles
+    inline void AccumulatePipelineStats(PipelineStats& total , const PipelineStats& stats) noexcept
+    {
+        for(int stage = 0; stage < PipelineStageCount; ++stage) total.stageNanoseconds[stage] += stats.stageNanoseconds[stage];
+        total.draws += stats.draws;
+        total.primitivesFrustumCulled += stats.primitivesFrustumCulled;
+        total.primitivesOcclusionCulled += stats.primitivesOcclusionCulled;
+        total.primitivesOcclusionFalseNegatives += stats.primitivesOcclusionFalseNegatives;
+        total.primitivesReordered += stats.primitivesReordered;
+        total.instancesFrustumCulled += stats.instancesFrustumCulled;
+        total.meshletsFrustumCulled += stats.meshletsFrustumCulled;
+        total.meshletsCullModeCulled += stats.meshletsCullModeCulled;
+        total.trianglesFrustumCulled += stats.trianglesFrustumCulled;
+        total.trianglesDegenerate += stats.trianglesDegenerate;
+        total.trianglesCullMode += stats.trianglesCullMode;
+        total.pixelsTested += stats.pixelsTested;
+        total.pixelsDepthRejected += stats.pixelsDepthRejected;
+    }
+
+    inline const char* GetPipelineStageName(PipelineStage stage) noexcept
+    {
+        constexpr const char* names[PipelineStageCount]{"vertex transform" , "culling" , "triangle setup" , "raster" , "shading" , "present"};
+        return names[stage];
+    }
+}
+
+#define SOFTWARE_STATS_CONCAT_INNER(a , b) a##b
+#define SOFTWARE_STATS_CONCAT(a , b) SOFTWARE_STATS_CONCAT_INNER(a , b)
+
+#ifdef SOFTWARE_PIPELINE_STATS
+#define SOFTWARE_STATS_TIMER(stats , stage) const software::ScopedStageTimer SOFTWARE_STATS_CONCAT(stageTimer , __LINE__){(stats).stageNanoseconds[stage]}
+#define SOFTWARE_STATS_ADD(stats , counter , amount) ((stats).counter += (amount))
+#define SOFTWARE_STATS_CODE(...) __VA_ARGS__
+#else
+#define SOFTWARE_STATS_TIMER(stats , stage)
+#define SOFTWARE_STATS_ADD(stats , counter , amount) ((void) 0)
+#define SOFTWARE_STATS_CODE(...)
+#endif
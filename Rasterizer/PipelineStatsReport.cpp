@@ -0,0 +1,63 @@
+#ifdef SOFTWARE_PIPELINE_STATS
+
+/// @brief print the stage times and counters of the last software frame, to check the scene against its budgets
+/// @brief raster and shading are summed over the worker threads, so they can add up to more than the frame time
+void Renderer::PrintSoftwarePipelineStats() const
+{
+    const software::PipelineStats& pipeline = m_RasterStats.pipeline;
+
+    std::cout << "software pipeline, last frame, " << m_RenderWidth << 'x' << m_RenderHeight << " of " << m_Width << 'x' << m_Height << '\n';
+    for(int stage = 0; stage < software::PipelineStageCount; ++stage)
+    {
+        std::cout << "  " << software::GetPipelineStageName(static_cast<software::PipelineStage>(stage)) << ": "
+            << pipeline.stageNanoseconds[stage] / 1000000.0 << " ms\n";
+    }
+
+    std::cout << "  primitives: " << pipeline.draws << " drawn, " << pipeline.primitivesFrustumCulled << " frustum culled by the scene bvh, "
+        << pipeline.instancesFrustumCulled << " instances frustum culled\n";
+    std::cout << "  occlusion: " << pipeline.primitivesOcclusionCulled << " primitives culled, " << pipeline.primitivesOcclusionFalseNegatives
+        << " false negatives\n";
+    std::cout << "  draw order: " << pipeline.primitivesReordered << " places moved since the last frame\n";
+    std::cout << "  meshlets: " << pipeline.meshletsFrustumCulled << " frustum culled, " << pipeline.meshletsCullModeCulled << " cull mode\n";
+    std::cout << "  triangles: " << m_RasterTriangles.size() << " rasterized, " << pipeline.trianglesFrustumCulled << " frustum culled, "
+        << pipeline.trianglesDegenerate << " degenerate, " << pipeline.trianglesCullMode << " cull mode\n";
+    std::cout << "  pixels: " << pipeline.pixelsTested << " tested, " << pipeline.pixelsDepthRejected << " depth rejected, "
+        << m_RasterStats.pixelsShaded << " shaded, " << m_RasterStats.pixelsCoarseShaded << " coarse shaded\n";
+
+    //only counted while a frame budget is set
+    if(m_DynamicResolution.GetBudget() > 0.0f)
+    {
+        std::cout << "  dynamic resolution: scale " << m_DynamicResolution.GetScale() << ", " << m_DynamicResolution.GetAverageFrameTime()
+            << " ms average, " << m_DynamicResolution.GetBudgetMissCount() << " of " << m_DynamicResolution.GetFrameCount()
+            << " frames over the " << m_DynamicResolution.GetBudget() << " ms budget\n";
+    }
+}
+
+/// @brief write the overdraw of the last software frame to a bmp, the amount of fragments that passed the depth test per pixel
+/// @brief at the internal resolution of the frame
+/// @brief black is not covered, then blue, cyan, green, yellow and red from 5 fragments on
+/// @param filePath the path of the image
+/// @return false if the file couldn't be written
+bool Renderer::SaveOverdrawHeatmap(const std::string& filePath) const
+{
+    constexpr uint32_t ramp[]{0x000000 , 0x0000FF , 0x00FFFF , 0x00FF00 , 0xFFFF00 , 0xFF0000};
+    constexpr uint32_t rampSize = sizeof(ramp) / sizeof(ramp[0]);
+
+    SDL_Surface* const pHeatmap = SDL_CreateRGBSurfaceWithFormat(0 , static_cast<int>(m_RenderWidth) , static_cast<int>(m_RenderHeight) , 32 , SDL_PIXELFORMAT_RGB888);
+    if(!pHeatmap) return false;
+
+    for(uint32_t r = 0; r < m_RenderHeight; ++r)
+    {
+        uint32_t* const pRow = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pHeatmap->pixels) + size_t(r) * pHeatmap->pitch);
+        for(uint32_t c = 0; c < m_RenderWidth; ++c)
+        {
+            pRow[c] = ramp[std::min(m_OverdrawBuffer[size_t(r) * m_RenderWidth + c] , rampSize - 1)];
+        }
+    }
+
+    const bool isSaved = SDL_SaveBMP(pHeatmap , filePath.c_str()) == 0;
+    SDL_FreeSurface(pHeatmap);
+    return isSaved;
+}
+
+#endif
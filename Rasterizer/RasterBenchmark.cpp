@@ -0,0 +1,453 @@
+/// @brief microbenchmark of the span rasterizers, runs the coverage and depth test of the triangles of the active scene through every instruction set
+/// @brief renders one frame first so the geometry stage has set up the triangles of the scene
+/// @param iterations how many times every triangle gets rasterized per instruction set
+void Renderer::BenchmarkRasterSpanFunctions(uint32_t iterations)
+{
+    RenderSoftware();
+
+    //far depth for every pixel, the benchmark measures coverage and not the depth buffer contents
+    const std::vector<float> depthRow(m_RenderWidth , FLT_MAX);
+    software::RasterFragment fragments[software::TileSize];
+
+    const std::pair<software::SimdLevel , const char*> levels[]
+    {
+        {software::SimdLevel::Scalar , "scalar"},
+        {software::SimdLevel::SSE , "sse"},
+        {software::SimdLevel::AVX2 , "avx2"}
+    };
+
+    std::cout << "span rasterizer benchmark, " << m_RasterTriangles.size() << " triangles, "
+        << iterations << " iterations, cpu supports " << levels[static_cast<int>(software::DetectSimdLevel())].second << '\n';
+
+    const software::RasterStats& rasterStats = GetSoftwareRasterStats();
+    std::cout << "8x8 blocks per frame: " << rasterStats.blocksRejected << " rejected, " << rasterStats.blocksAccepted << " accepted, "
+        << rasterStats.blocksPartial << " partial\n";
+    std::cout << "pixels shaded per frame: " << rasterStats.pixelsShaded << " for " << m_RenderWidth * m_RenderHeight << " pixels rendered\n";
+
+    for(const auto& [level , name] : levels)
+    {
+        if(level > software::DetectSimdLevel()) continue;
+
+        const software::RasterizeSpanFunction rasterizeSpan = software::GetRasterizeSpanFunction(level);
+        uint64_t fragmentCount = 0;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(uint32_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            for(const software::RasterTriangle& triangle : m_RasterTriangles)
+            {
+                const software::PixelRect& bounds = triangle.pixelBounds;
+                for(int row = bounds.top; row <= bounds.bottom; ++row)
+                {
+                    //spans are at most a tile wide, like in the tile raster stage
+                    for(int left = bounds.left; left <= bounds.right; left += software::TileSize)
+                    {
+                        const int count = std::min(bounds.right - left + 1 , static_cast<int>(software::TileSize));
+                        fragmentCount += rasterizeSpan(triangle.edges , left , row , count , &depthRow[left] , fragments , true);
+                    }
+                }
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        const float milliseconds = std::chrono::duration<float , std::milli>(end - start).count();
+        std::cout << name << ": " << milliseconds / iterations << " ms per frame, "
+            << fragmentCount / iterations << " fragments\n";
+    }
+}
+
+/// @brief benchmark of the raster kernels specialized on the state of the primitives against the runtime kernel, on the active scene
+/// @brief renders whole frames, the difference is in the raster and shading loops, the geometry stage is the same for both
+/// @param frameCount how many frames get rendered per kernel variant, after one warm up frame each
+void Renderer::BenchmarkRasterKernels(uint32_t frameCount)
+{
+    const std::pair<bool , const char*> variants[]
+    {
+        {true , "runtime state"},
+        {false , "specialized"}
+    };
+
+    std::cout << "raster kernel benchmark, " << frameCount << " frames, "
+        << (m_ShadingMode == software::ShadingMode::Deferred ? "deferred" : "forward") << " shading\n";
+
+    float runtimeMilliseconds = 0.0f;
+    for(const auto& [useRuntimeKernels , name] : variants)
+    {
+        SetUseRuntimeRasterKernels(useRuntimeKernels);
+        RenderSoftware();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            RenderSoftware();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        const float milliseconds = std::chrono::duration<float , std::milli>(end - start).count() / frameCount;
+        if(useRuntimeKernels) runtimeMilliseconds = milliseconds;
+
+        std::cout << name << ": " << milliseconds << " ms per frame";
+        if(!useRuntimeKernels) std::cout << ", " << runtimeMilliseconds / milliseconds << "x";
+        std::cout << '\n';
+    }
+
+    std::cout << "pixels shaded per frame: " << GetSoftwareRasterStats().pixelsShaded << " in " << m_RasterTriangles.size() << " triangles\n";
+}
+
+/// @brief benchmark of the load time index buffer optimization, vertex cache order then overdraw order, on the active scene
+/// @brief the meshlets of every mesh get rebuilt from the optimized triangles, consecutive triangles sharing vertices means less
+/// @brief vertices duplicated across meshlets and tighter meshlet bounds to cull on, the source order is restored after
+/// @param frameCount how many frames get rendered per index order, after one warm up frame each
+void Renderer::BenchmarkMeshOptimization(uint32_t frameCount)
+{
+    const auto measureFrames = [this , frameCount]()
+    {
+        RenderSoftware();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            RenderSoftware();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<float , std::milli>(end - start).count() / frameCount;
+    };
+    const auto countMeshletVertices = [this]()
+    {
+        size_t vertexCount = 0;
+        for(const auto& [pIndexBuffer , meshletMesh] : m_MeshletMeshes) vertexCount += meshletMesh.streams.vertexCount;
+        return vertexCount;
+    };
+
+    const float sourceMilliseconds = measureFrames();
+    const size_t sourceMeshletVertices = countMeshletVertices();
+
+    //every mesh once, the primitives that share a mesh share its meshlets
+    size_t triangleCount = 0;
+    float sourceMisses = 0.0f;
+    float optimizedMisses = 0.0f;
+    std::unordered_set<const void*> optimizedMeshes;
+    for(const Primitive* primitive : SceneManager::GetInstance()->GetActiveScene()->GetPrimitives())
+    {
+        const auto& indexBuffer = primitive->GetMesh()->pMeshData->indexBufferSR;
+        if(!optimizedMeshes.insert(&indexBuffer).second) continue;
+
+        const software::ObjectVertexStreams& objectStreams = GetObjectVertexStreams(primitive);
+        std::vector<uint32_t> indices = (primitive->GetTopology() == PrimitiveTopology::TriangleStrip)
+            ? software::ConvertTriangleStripToList(indexBuffer) : std::vector<uint32_t>(indexBuffer.begin() , indexBuffer.end());
+
+        const size_t meshTriangles = indices.size() / 3;
+        triangleCount += meshTriangles;
+        sourceMisses += software::GetAverageCacheMissRatio(indices , objectStreams.vertexCount) * meshTriangles;
+
+        software::OptimizeVertexCache(indices , objectStreams.vertexCount);
+        software::OptimizeOverdraw(indices , objectStreams);
+        optimizedMisses += software::GetAverageCacheMissRatio(indices , objectStreams.vertexCount) * meshTriangles;
+
+        //the optimized meshlets take the place of the ones built from the source order
+        software::MeshletMesh& meshletMesh = m_MeshletMeshes[&indexBuffer];
+        meshletMesh = software::MeshletMesh{};
+        software::BuildMeshlets(objectStreams , indices , false , meshletMesh);
+    }
+
+    const size_t optimizedMeshletVertices = countMeshletVertices();
+    const float optimizedMilliseconds = measureFrames();
+
+    std::cout << "mesh optimization benchmark, " << frameCount << " frames, " << triangleCount << " triangles\n";
+    if(triangleCount > 0)
+    {
+        std::cout << "vertex transforms per triangle with a " << software::CacheMissRatioCacheSize << " entry fifo cache: "
+            << sourceMisses / triangleCount << " source, " << optimizedMisses / triangleCount << " optimized\n";
+    }
+    std::cout << "meshlet vertices: " << sourceMeshletVertices << " source, " << optimizedMeshletVertices << " optimized\n";
+    std::cout << "source order: " << sourceMilliseconds << " ms per frame\n";
+    std::cout << "optimized order: " << optimizedMilliseconds << " ms per frame, " << sourceMilliseconds / optimizedMilliseconds << "x\n";
+
+    //the meshlets get rebuilt from the source order the next frame
+    m_MeshletMeshes.clear();
+}
+
+/// @brief quality against time of the variable rate shading, deferred shading at the full rate and at the rate of the blocks
+/// @brief the last frame of both gets compared on the clamped colors, the resolve clamps them the same way
+/// @param frameCount how many frames get rendered per rate, after warm up frames so the rates of the blocks settled
+void Renderer::BenchmarkVariableRateShading(uint32_t frameCount)
+{
+    const software::ShadingMode previousMode = m_ShadingMode;
+    SetSoftwareShadingMode(software::ShadingMode::Deferred);
+
+    const auto measureFrames = [this , frameCount]()
+    {
+        RenderSoftware();
+        RenderSoftware();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            RenderSoftware();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<float , std::milli>(end - start).count() / frameCount;
+    };
+
+    SetSoftwareVariableRateShading(false);
+    const float fullMilliseconds = measureFrames();
+    const uint64_t fullPixelsShaded = GetSoftwareRasterStats().pixelsShaded;
+    const std::vector<float> fullColors = m_ColorBuffer;
+
+    SetSoftwareVariableRateShading(true);
+    const float coarseMilliseconds = measureFrames();
+    const software::RasterStats& coarseStats = GetSoftwareRasterStats();
+
+    std::cout << "variable rate shading benchmark, " << frameCount << " frames, deferred shading\n";
+    std::cout << "full rate: " << fullMilliseconds << " ms per frame, " << fullPixelsShaded << " pixels shaded\n";
+    std::cout << "variable rate: " << coarseMilliseconds << " ms per frame, " << coarseStats.pixelsShaded << " pixels shaded, "
+        << coarseStats.pixelsCoarseShaded << " coarse shaded, " << fullMilliseconds / coarseMilliseconds << "x\n";
+
+    //the dynamic resolution can change the size between the runs, then there is nothing to compare
+    if(fullColors.size() == m_ColorBuffer.size())
+    {
+        double squaredErrorSum = 0.0;
+        float maxError = 0.0f;
+        for(size_t i = 0; i < fullColors.size(); i += 4)
+        {
+            for(size_t channel = 0; channel < 3; ++channel)
+            {
+                const float error = std::abs(std::clamp(fullColors[i + channel] , 0.0f , 1.0f) - std::clamp(m_ColorBuffer[i + channel] , 0.0f , 1.0f));
+                squaredErrorSum += double(error) * error;
+                maxError = std::max(maxError , error);
+            }
+        }
+
+        const double meanSquaredError = squaredErrorSum / (fullColors.size() / 4 * 3);
+        std::cout << "quality: ";
+        if(meanSquaredError > 0.0) std::cout << 10.0 * std::log10(1.0 / meanSquaredError) << " dB psnr";
+        else std::cout << "identical";
+        std::cout << ", largest channel error " << maxError * 255.0f << " of 255\n";
+    }
+
+    SetSoftwareVariableRateShading(false);
+    SetSoftwareShadingMode(previousMode);
+}
+
+/// @brief rasterize a dense tessellated quad and count the pixels written more than once or not at all, for every instruction set
+/// @brief the interior vertices are jittered on the sub pixel grid and the outer edges go through pixel centers, so the fill rule decides
+/// @brief the triangles go through the same block classification as in the tile raster stage
+/// @param cellCount the quad is split into cellCount x cellCount cells of 2 triangles
+/// @return true if every pixel of the quad was written exactly once and nothing outside of it
+bool Renderer::VerifyRasterFillRule(uint32_t cellCount)
+{
+    //pixel centers from 8.5 up to but without 248.5, the left and top edges include them, the right and bottom ones don't
+    constexpr int imageSize = 256;
+    constexpr float quadStart = 8.5f;
+    constexpr float quadSize = 240.0f;
+    const float cellSize = quadSize / static_cast<float>(cellCount);
+
+    std::vector<FPoint4> vertices;
+    for(uint32_t j = 0; j <= cellCount; ++j)
+    {
+        for(uint32_t i = 0; i <= cellCount; ++i)
+        {
+            //at most a quarter of a cell, the cells never fold over
+            const bool isBorder = i == 0 || j == 0 || i == cellCount || j == cellCount;
+            const float jitterX = isBorder ? 0.0f : static_cast<float>(int((i * 7 + j * 13) % 9) - 4) * cellSize / 16.0f;
+            const float jitterY = isBorder ? 0.0f : static_cast<float>(int((i * 11 + j * 5) % 9) - 4) * cellSize / 16.0f;
+            vertices.push_back(FPoint4{software::SnapToSubPixel(quadStart + static_cast<float>(i) * cellSize + jitterX)
+                , software::SnapToSubPixel(quadStart + static_cast<float>(j) * cellSize + jitterY) , 0.5f , 1.0f});
+        }
+    }
+
+    //both diagonals, so shared edges run in every direction
+    std::vector<uint32_t> indices;
+    for(uint32_t j = 0; j < cellCount; ++j)
+    {
+        for(uint32_t i = 0; i < cellCount; ++i)
+        {
+            const uint32_t a = j * (cellCount + 1) + i , b = a + 1 , d = a + cellCount + 1 , c = d + 1;
+            const uint32_t cell[6]{a , b , c , a , c , d};
+            const uint32_t flippedCell[6]{a , b , d , b , c , d};
+            indices.insert(indices.end() , ((i + j) % 2) ? std::begin(cell) : std::begin(flippedCell) , ((i + j) % 2) ? std::end(cell) : std::end(flippedCell));
+        }
+    }
+
+    const std::vector<float> depthRow(imageSize , FLT_MAX);
+    software::RasterFragment fragments[software::BlockSize];
+
+    const std::pair<software::SimdLevel , const char*> levels[]
+    {
+        {software::SimdLevel::Scalar , "scalar"},
+        {software::SimdLevel::SSE , "sse"},
+        {software::SimdLevel::AVX2 , "avx2"}
+    };
+
+    std::cout << "fill rule verification, " << indices.size() / 3 << " triangles\n";
+
+    bool isCorrect = true;
+    for(const auto& [level , name] : levels)
+    {
+        if(level > software::DetectSimdLevel()) continue;
+        const software::RasterizeSpanFunction rasterizeSpan = software::GetRasterizeSpanFunction(level);
+
+        std::vector<uint32_t> writeCounts(size_t(imageSize) * imageSize , 0);
+        for(size_t t = 0; t < indices.size(); t += 3)
+        {
+            const FPoint4& position0 = vertices[indices[t]];
+            const FPoint4& position1 = vertices[indices[t + 1]];
+            const FPoint4& position2 = vertices[indices[t + 2]];
+
+            const int64_t fixedPointArea = software::GetFixedPointArea(position0 , position1 , position2);
+            const float areaParallelogram = static_cast<float>(fixedPointArea) / float(software::SubPixelSteps * software::SubPixelSteps);
+            const software::TriangleEdges edges = software::SetupTriangleEdges(position0 , position1 , position2 , areaParallelogram);
+
+            const software::PixelRect bounds
+            {
+                static_cast<int>(std::min({position0.x , position1.x , position2.x})),
+                static_cast<int>(std::min({position0.y , position1.y , position2.y})),
+                static_cast<int>(std::ceil(std::max({position0.x , position1.x , position2.x}))),
+                static_cast<int>(std::ceil(std::max({position0.y , position1.y , position2.y})))
+            };
+
+            for(int blockTop = bounds.top - bounds.top % software::BlockSize; blockTop <= bounds.bottom; blockTop += software::BlockSize)
+            {
+                for(int blockLeft = bounds.left - bounds.left % software::BlockSize; blockLeft <= bounds.right; blockLeft += software::BlockSize)
+                {
+                    const software::PixelRect block = software::GetIntersection(bounds
+                        , software::PixelRect{blockLeft , blockTop , blockLeft + software::BlockSize - 1 , blockTop + software::BlockSize - 1});
+
+                    const software::BlockCoverage coverage = software::ClassifyBlock(edges , block.left , block.top , block.right , block.bottom);
+                    if(coverage == software::BlockCoverage::Outside) continue;
+
+                    for(int row = block.top; row <= block.bottom; ++row)
+                    {
+                        const uint32_t fragmentCount = rasterizeSpan(edges , block.left , row , block.right - block.left + 1
+                            , &depthRow[block.left] , fragments , coverage == software::BlockCoverage::Partial);
+                        for(uint32_t f = 0; f < fragmentCount; ++f) ++writeCounts[size_t(row) * imageSize + fragments[f].x];
+                    }
+                }
+            }
+        }
+
+        uint32_t holeCount = 0 , overlapCount = 0 , outsideCount = 0;
+        for(int row = 0; row < imageSize; ++row)
+        {
+            for(int column = 0; column < imageSize; ++column)
+            {
+                const uint32_t writeCount = writeCounts[size_t(row) * imageSize + column];
+                const bool isInQuad = column >= 8 && column < 248 && row >= 8 && row < 248;
+
+                if(!isInQuad) outsideCount += writeCount > 0 ? 1 : 0;
+                else if(writeCount == 0) ++holeCount;
+                else if(writeCount > 1) ++overlapCount;
+            }
+        }
+
+        std::cout << name << ": " << overlapCount << " pixels written more than once, " << holeCount << " holes, "
+            << outsideCount << " pixels outside the quad\n";
+        isCorrect = isCorrect && holeCount == 0 && overlapCount == 0 && outsideCount == 0;
+    }
+    return isCorrect;
+}
+
+/// @brief rasterize a triangle crossing the near plane and check the depth of every fragment against the depth of its pixel ray
+/// @brief the clipper puts new vertices on z = 0, the depth has to interpolate through them and not go to 0 or nan
+/// @return true if every fragment of every instruction set has the depth of the triangle at its pixel
+bool Renderer::VerifyNearPlaneClipping()
+{
+    //a 90 degree square frustum with z in 0 to 1, clip x = view x, clip y = view y, clip w = view z
+    constexpr int imageSize = 256;
+    constexpr float nearPlane = 1.0f;
+    constexpr float farPlane = 10.0f;
+    const auto toClip = [](float x , float y , float z)
+    {
+        return FPoint4{x , y , farPlane / (farPlane - nearPlane) * (z - nearPlane) , z};
+    };
+
+    //two vertices behind the near plane, the third far away, the triangle leans away from the camera
+    const FVector3 view0{-4.0f , -1.0f , 0.5f};
+    const FVector3 view1{4.0f , -1.0f , 0.5f};
+    const FVector3 view2{0.0f , 2.0f , 8.0f};
+
+    software::ClipVertex triangle[3]{};
+    triangle[0].position = toClip(view0.x , view0.y , view0.z);
+    triangle[1].position = toClip(view1.x , view1.y , view1.z);
+    triangle[2].position = toClip(view2.x , view2.y , view2.z);
+
+    software::ClipVertex polygon[software::MaxClippedVertices];
+    const uint32_t polygonVertexCount = software::ClipTriangle(triangle , software::ClipNear , polygon);
+
+    //the same projection as the triangle setup, the image is the viewport
+    for(uint32_t v = 0; v < polygonVertexCount; ++v)
+    {
+        FPoint4& position = polygon[v].position;
+        const float invW = 1.0f / position.w;
+        position.x = software::SnapToSubPixel((position.x * invW + 1.0f) * 0.5f * imageSize);
+        position.y = software::SnapToSubPixel((1.0f - position.y * invW) * 0.5f * imageSize);
+        position.z *= invW;
+    }
+
+    //the depth where the ray of a pixel center hits the plane of the triangle in view space
+    const FVector3 planeNormal = Cross(view1 - view0 , view2 - view0);
+    const float planeDistance = Dot(planeNormal , view0);
+    const auto getReferenceDepth = [&planeNormal , planeDistance](int x , int y)
+    {
+        const FVector3 ray{(static_cast<float>(x) + 0.5f) / (imageSize * 0.5f) - 1.0f , 1.0f - (static_cast<float>(y) + 0.5f) / (imageSize * 0.5f) , 1.0f};
+        const float viewZ = planeDistance / Dot(planeNormal , ray);
+        return farPlane / (farPlane - nearPlane) * (1.0f - nearPlane / viewZ);
+    };
+
+    const std::vector<float> depthRow(imageSize , FLT_MAX);
+    software::RasterFragment fragments[software::BlockSize];
+
+    const std::pair<software::SimdLevel , const char*> levels[]
+    {
+        {software::SimdLevel::Scalar , "scalar"},
+        {software::SimdLevel::SSE , "sse"},
+        {software::SimdLevel::AVX2 , "avx2"}
+    };
+
+    std::cout << "near plane clipping verification, " << polygonVertexCount << " clipped vertices\n";
+
+    bool isCorrect = polygonVertexCount >= 3;
+    for(const auto& [level , name] : levels)
+    {
+        if(level > software::DetectSimdLevel()) continue;
+        const software::RasterizeSpanFunction rasterizeSpan = software::GetRasterizeSpanFunction(level);
+
+        uint64_t fragmentCount = 0;
+        uint64_t wrongDepthCount = 0;
+        float maxError = 0.0f;
+        for(uint32_t v = 1; v + 1 < polygonVertexCount; ++v)
+        {
+            const FPoint4& position0 = polygon[0].position;
+            const FPoint4& position1 = polygon[v].position;
+            const FPoint4& position2 = polygon[v + 1].position;
+
+            const int64_t fixedPointArea = software::GetFixedPointArea(position0 , position1 , position2);
+            if(fixedPointArea == 0) continue;
+            const float areaParallelogram = static_cast<float>(fixedPointArea) / float(software::SubPixelSteps * software::SubPixelSteps);
+            const software::TriangleEdges edges = software::SetupTriangleEdges(position0 , position1 , position2 , areaParallelogram);
+
+            const int top = std::max(static_cast<int>(std::min({position0.y , position1.y , position2.y})) , 0);
+            const int bottom = std::min(static_cast<int>(std::ceil(std::max({position0.y , position1.y , position2.y}))) , imageSize - 1);
+            //spans of a block wide, like the tile raster stage, the edge functions step in 32 bit
+            for(int row = top; row <= bottom; ++row)
+            {
+                for(int left = 0; left < imageSize; left += software::BlockSize)
+                {
+                    const uint32_t spanFragmentCount = rasterizeSpan(edges , left , row , software::BlockSize , &depthRow[left] , fragments , true);
+                    for(uint32_t f = 0; f < spanFragmentCount; ++f)
+                    {
+                        const software::RasterFragment& fragment = fragments[f];
+                        const float error = std::abs(fragment.depth - getReferenceDepth(static_cast<int>(fragment.x) , row));
+                        if(!(error <= 1e-3f)) ++wrongDepthCount;
+                        maxError = std::max(maxError , error);
+                    }
+                    fragmentCount += spanFragmentCount;
+                }
+            }
+        }
+
+        std::cout << name << ": " << fragmentCount << " fragments, " << wrongDepthCount << " with a wrong depth, largest error " << maxError << '\n';
+        isCorrect = isCorrect && fragmentCount > 0 && wrongDepthCount == 0;
+    }
+    return isCorrect;
+}
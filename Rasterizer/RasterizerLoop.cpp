@@ -1,184 +1,1369 @@
 /// @brief render loop of the software
+/// @brief geometry stage sets up the triangles and bins them into screen tiles, then the tiles get rasterized in parallel
+/// @brief every tile owns its part of the depth and color buffer, so the output is the same for any thread count
+/// @brief shading and blending happen in a linear float color buffer, resolved to the back buffer once at the end
+/// @brief all temporaries live in the frame arena, in a steady state the frame does no heap allocations
+/// @brief draws the scene as it is now, the pipelined frame loop draws from a snapshot instead
 void Renderer::RenderSoftware()
 {
-    SDL_LockSurface(m_pBackBuffer);
-    RGBColor targetColor;
-    software::VS_OUTPUT vertexOUT;
-    std::vector<software::VS_OUTPUT> transformedVertices;
-    std::vector<uint32_t> indices;
-    size_t sizeIndexBuffer = 0;
+    CaptureFrameSnapshot(m_FrameSnapshot);
+    BeginSoftwarePresent();
+    RenderSoftware(m_FrameSnapshot);
+    PresentSoftware();
+}
 
-    ClearBackBuffer();
+/// @brief render a frame from a snapshot of the scene, reads nothing the update changes so the next update can run next to it
+/// @brief it resolves into the surface BeginSoftwarePresent locked and makes no sdl video calls, PresentSoftware shows it
+/// @param snapshot the transforms of the primitives and the camera of the frame
+void Renderer::RenderSoftware(const FrameSnapshot& snapshot)
+{
+    const auto frameStart = std::chrono::high_resolution_clock::now();
+    const uint64_t heapAllocationsAtStart = software::GetHeapAllocationCount();
 
-    //go over all the triangles
-    for(Primitive* primitive : SceneManager::GetInstance()->GetActiveScene()->GetPrimitives())
-    {
-        transformedVertices.clear();
+    if(!m_pTileWorkerPool) SetSoftwareThreadCount(std::thread::hardware_concurrency());
+    if(!m_RasterizeSpan) SetRasterSimdLevel(software::SimdLevel::AVX2);
 
-        //get Indices
-        indices = primitive->GetMesh()->pMeshData->indexBufferSR;
+    const std::vector<Primitive*>& primitives = snapshot.primitives;
 
-        //get topology
-        const PrimitiveTopology currentTopology = primitive->GetTopology();
+    BeginSoftwareFrame(snapshot);
 
-        //store resulting verts from transformations (world,camera,ndc,raster)
-        VertexTransformationFunction(primitive->GetMesh()->pMeshData->vertexBufferSR
-            , transformedVertices , primitive->GetWorldMatrix());
+    //whole primitives outside the frustum are skipped before their vertices get transformed
+    const FMatrix4& viewProjectionMatrix = m_ViewProjectionMatrix;
+    m_SceneBVH.Update(primitives , snapshot.worldMatrices , [this](const Primitive* primitive) { return GetObjectBounds(primitive); });
+    m_SceneBVH.CullFrustum(viewProjectionMatrix , m_IsPrimitiveVisible);
 
-//set index buffer size based on topology
-        const sizeIndexBuffer = (currentTopology == PrimitiveTopology::TriangleList) ? indices.size() : indices.size() - 2;
+    //then the ones hidden behind the depth of the previous frame
+    if(m_UseOcclusionCulling) CullOccludedPrimitives(viewProjectionMatrix);
 
-        //set looping based on topology
-        const int increaseIndexValue = (currentTopology == PrimitiveTopology::TriangleList) ? 3 : 1;
+    //the opaque primitives front to back, then the blended ones back to front
+    for(size_t primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex)
+    {
+        m_IsPrimitiveBlended[primitiveIndex] = snapshot.renderStates[primitiveIndex].shouldBlend ? 1 : 0;
+    }
+    m_DrawOrder.Update(m_SceneBVH , m_IsPrimitiveBlended , viewProjectionMatrix);
+    SOFTWARE_STATS_ADD(m_PipelineStats , primitivesReordered , m_DrawOrder.GetMoveCount());
 
-        //for every triangle
-        for(uint64_t i = 0; i < sizeIndexBuffer; i += increaseIndexValue)
+    //geometry stage, in draw order so every bin stays sorted on it
+    for(const uint32_t primitiveIndex : m_DrawOrder.GetOrder())
+    {
+        if(!m_IsPrimitiveVisible[primitiveIndex])
         {
-            const uint64_t evenIndex = (currentTopology == PrimitiveTopology::TriangleStrip) ? (i % 2) : 0;
+            SOFTWARE_STATS_ADD(m_PipelineStats , primitivesFrustumCulled , 1);
+            continue;
+        }
+        if(m_IsPrimitiveOccluded[primitiveIndex])
+        {
+            SOFTWARE_STATS_ADD(m_PipelineStats , primitivesOcclusionCulled , 1);
+            continue;
+        }
+        SetupPrimitiveTriangles(primitives[primitiveIndex] , snapshot.worldMatrices[primitiveIndex] , snapshot.renderStates[primitiveIndex]
+            , m_TransformedStreams[primitiveIndex]);
+    }
+    m_RasterTriangles = m_RasterTriangles.first(m_RasterTriangleCount);
+
+    BinRasterTriangles();
+
+    //raster stage
+    m_pTileWorkerPool->Run(m_TilesX * m_TilesY , [this](uint32_t tileIndex) { RasterizeTile(tileIndex); });
 
-            //set index based on topology
-            const uint64_t index0 = indices[i] , index1 = indices[i + static_cast<uint64_t>(1)
-                + evenIndex] , index2 = indices[i + static_cast<uint64_t>(2) - evenIndex];
+    //the hierarchical z is complete, it is the occluder of the next frame
+    if(m_UseOcclusionCulling) CaptureOcclusionDepth(viewProjectionMatrix);
+
+    //every tile counted on its own, no need for atomics
+    m_RasterStats = software::RasterStats{};
+    for(const software::RasterStats& tileStats : m_TileRasterStats)
+    {
+        m_RasterStats.blocksRejected += tileStats.blocksRejected;
+        m_RasterStats.blocksAccepted += tileStats.blocksAccepted;
+        m_RasterStats.blocksPartial += tileStats.blocksPartial;
+        m_RasterStats.blocksOccluded += tileStats.blocksOccluded;
+        m_RasterStats.trianglesOccluded += tileStats.trianglesOccluded;
+        m_RasterStats.pixelsShaded += tileStats.pixelsShaded;
+        m_RasterStats.pixelsCoarseShaded += tileStats.pixelsCoarseShaded;
+        SOFTWARE_STATS_CODE(software::AccumulatePipelineStats(m_RasterStats.pipeline , tileStats.pipeline));
+    }
+
+    {
+        SOFTWARE_STATS_TIMER(m_PipelineStats , software::StagePresent);
+
+        //the resolve writes the window surface itself when it can, then there is no back buffer copy
+        ResolveColorBuffer(m_pPresentTarget);
+    }
+
+    //the geometry stage and the resolve ran on this thread
+    SOFTWARE_STATS_CODE(software::AccumulatePipelineStats(m_RasterStats.pipeline , m_PipelineStats));
+
+    m_FrameAllocationCount = software::GetHeapAllocationCount() - heapAllocationsAtStart;
+
+    //picks the internal resolution of the next frame
+    m_DynamicResolution.Update(std::chrono::duration<float , std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count());
+}
+
+/// @brief reset the per frame state of the software renderer, everything that outlives the frame only reallocates
+/// @brief when the resolution or the scene grows
+/// @param snapshot the primitives and the camera of the frame
+void Renderer::BeginSoftwareFrame(const FrameSnapshot& snapshot)
+{
+    const std::vector<Primitive*>& primitives = snapshot.primitives;
+    m_ViewProjectionMatrix = snapshot.projectionMatrix * snapshot.viewMatrix;
+    m_CameraPosition = snapshot.cameraPosition;
 
-                            //get 3 triangle verts
-            FPoint4 vertex0{transformedVertices[index0].position} ,
-                vertex1{transformedVertices[index1].position} , vertex2{transformedVertices[index2].position};
+    m_FrameArena.Reset();
 
-                            //check if triangle is outside frustum
-            if(GameManager::GetInstance()->GetFrustumCullingMode() == FrustumCullingMode::OneVertexMode)
+    //the internal resolution of this frame, smaller than the window when the frame time is over budget
+    m_RenderWidth = m_DynamicResolution.GetScaledSize(m_Width);
+    m_RenderHeight = m_DynamicResolution.GetScaledSize(m_Height);
+    m_RenderScaleX = static_cast<float>(m_RenderWidth) / static_cast<float>(m_Width);
+    m_RenderScaleY = static_cast<float>(m_RenderHeight) / static_cast<float>(m_Height);
+
+    m_TilesX = (m_RenderWidth + software::TileSize - 1) / software::TileSize;
+    m_TilesY = (m_RenderHeight + software::TileSize - 1) / software::TileSize;
+    m_HiZWidth = (m_RenderWidth + software::BlockSize - 1) / software::BlockSize;
+    m_HiZHeight = (m_RenderHeight + software::BlockSize - 1) / software::BlockSize;
+
+    m_DepthBuffer.resize(size_t(m_RenderWidth) * m_RenderHeight);
+    m_ColorBuffer.resize(size_t(m_RenderWidth) * m_RenderHeight * 4);
+    m_HiZBuffer.resize(size_t(m_HiZWidth) * m_HiZHeight);
+    m_TileRasterStats.resize(size_t(m_TilesX) * m_TilesY);
+    m_TransformedStreams.resize(primitives.size());
+    m_IsPrimitiveVisible.resize(primitives.size());
+    m_IsPrimitiveOccluded.resize(primitives.size());
+    m_IsOcclusionTestSkipped.resize(primitives.size());
+    m_IsPrimitiveBlended.resize(primitives.size());
+
+    //only the deferred mode needs the visibility buffer, it gets cleared per tile
+    if(m_ShadingMode == software::ShadingMode::Deferred) m_VisibilityBuffer.resize(size_t(m_RenderWidth) * m_RenderHeight);
+
+    //the rates picked by the last frame, a new block starts at the full rate
+    if(m_ShadingMode == software::ShadingMode::Deferred && m_UseVariableRateShading) m_BlockShadingRates.resize(size_t(m_HiZWidth) * m_HiZHeight);
+
+    //clear in place instead of reallocating
+    FillFloats(m_DepthBuffer.data() , m_DepthBuffer.size() , FLT_MAX);
+    FillFloats(m_ColorBuffer.data() , m_ColorBuffer.size() , 0.0f);
+    FillFloats(m_HiZBuffer.data() , m_HiZBuffer.size() , FLT_MAX);
+    std::fill(m_TileRasterStats.begin() , m_TileRasterStats.end() , software::RasterStats{});
+    std::fill(m_IsPrimitiveOccluded.begin() , m_IsPrimitiveOccluded.end() , uint8_t(0));
+
+    //the streams of the previous frame point into the reset arena
+    std::fill(m_TransformedStreams.begin() , m_TransformedStreams.end() , software::TransformedVertexStreams{});
+
+    SOFTWARE_STATS_CODE
+    (
+        m_PipelineStats = software::PipelineStats{};
+        m_OverdrawBuffer.resize(size_t(m_RenderWidth) * m_RenderHeight);
+        std::fill(m_OverdrawBuffer.begin() , m_OverdrawBuffer.end() , 0u);
+    )
+
+    //the triangles in the index buffers, only clipping can make more
+    size_t maxTriangleCount = 0;
+    for(const Primitive* primitive : primitives)
+    {
+        const size_t indexCount = primitive->GetMesh()->pMeshData->indexBufferSR.size();
+        const InstancedPrimitive* const pInstanced = dynamic_cast<const InstancedPrimitive*>(primitive);
+        const size_t instanceCount = pInstanced ? pInstanced->GetInstanceTransforms().size() : 1;
+        maxTriangleCount += ((primitive->GetTopology() == PrimitiveTopology::TriangleList) ? indexCount / 3 : indexCount) * instanceCount;
+    }
+    m_RasterTriangles = m_FrameArena.AllocateArray<software::RasterTriangle>(maxTriangleCount);
+    m_RasterTriangleCount = 0;
+}
+
+/// @brief fill a float buffer 16 floats per iteration, used to clear the depth and color buffers in place
+/// @param pBuffer the buffer to fill
+/// @param count the amount of floats
+/// @param value the value to write
+void Renderer::FillFloats(float* pBuffer , size_t count , float value)
+{
+    const __m128 fill = _mm_set1_ps(value);
+
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        _mm_storeu_ps(pBuffer + i , fill);
+        _mm_storeu_ps(pBuffer + i + 4 , fill);
+        _mm_storeu_ps(pBuffer + i + 8 , fill);
+        _mm_storeu_ps(pBuffer + i + 12 , fill);
+    }
+    for(; i < count; ++i) pBuffer[i] = value;
+}
+
+/// @brief sort the set up triangles into the bins of the tiles they overlap, a counting sort into the frame arena
+/// @brief the triangles are visited in draw order, so every bin stays sorted on draw order
+void Renderer::BinRasterTriangles()
+{
+    const size_t tileCount = size_t(m_TilesX) * m_TilesY;
+
+    //count per tile, offset i + 1 holds the count of tile i
+    m_TileBinOffsets = m_FrameArena.AllocateArray<uint32_t>(tileCount + 1);
+    std::fill(m_TileBinOffsets.begin() , m_TileBinOffsets.end() , 0u);
+
+    for(const software::RasterTriangle& triangle : m_RasterTriangles)
+    {
+        const software::PixelRect tiles = GetTileRange(triangle.pixelBounds);
+        for(int tileY = tiles.top; tileY <= tiles.bottom; ++tileY)
+        {
+            for(int tileX = tiles.left; tileX <= tiles.right; ++tileX)
             {
-                if(!GetIsPointInsideFrustum(vertex0) && !GetIsPointInsideFrustum(vertex1)
-                    && !GetIsPointInsideFrustum(vertex2)) continue;
+                ++m_TileBinOffsets[size_t(tileY) * m_TilesX + tileX + 1];
             }
-            else
+        }
+    }
+
+    //prefix sum, offset i is now the start of tile i
+    for(size_t tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+    {
+        m_TileBinOffsets[tileIndex + 1] += m_TileBinOffsets[tileIndex];
+    }
+
+    m_TileBinTriangles = m_FrameArena.AllocateArray<uint32_t>(m_TileBinOffsets[tileCount]);
+
+    //fill, using a copy of the start offsets as write cursors
+    const std::span<uint32_t> cursors = m_FrameArena.AllocateArray<uint32_t>(tileCount);
+    std::copy(m_TileBinOffsets.begin() , m_TileBinOffsets.begin() + tileCount , cursors.begin());
+
+    for(uint32_t triangleIndex = 0; triangleIndex < m_RasterTriangles.size(); ++triangleIndex)
+    {
+        const software::PixelRect tiles = GetTileRange(m_RasterTriangles[triangleIndex].pixelBounds);
+        for(int tileY = tiles.top; tileY <= tiles.bottom; ++tileY)
+        {
+            for(int tileX = tiles.left; tileX <= tiles.right; ++tileX)
             {
-                if(!GetIsPointInsideFrustum(vertex0) || !GetIsPointInsideFrustum(vertex1)
-                    || !GetIsPointInsideFrustum(vertex2)) continue;
+                m_TileBinTriangles[cursors[size_t(tileY) * m_TilesX + tileX]++] = triangleIndex;
             }
+        }
+    }
+}
+
+/// @brief get the tiles a rectangle of pixels overlaps
+/// @param pixelRect the pixels
+/// @return inclusive range of tile columns and rows
+software::PixelRect Renderer::GetTileRange(const software::PixelRect& pixelRect) const noexcept
+{
+    return software::PixelRect
+    {
+        pixelRect.left / int(software::TileSize),
+        pixelRect.top / int(software::TileSize),
+        pixelRect.right / int(software::TileSize),
+        pixelRect.bottom / int(software::TileSize)
+    };
+}
+
+/// @brief get the amount of heap allocations during the last software frame, 0 in a steady state
+/// @brief counted by the replaced global operator new, so only in a build with SOFTWARE_COUNT_ALLOCATIONS
+/// @brief the count is process wide, in the pipelined loop it includes what the update thread allocated meanwhile
+/// @return the allocations from the start of the frame to the end of the resolve, always 0 without SOFTWARE_COUNT_ALLOCATIONS
+uint64_t Renderer::GetSoftwareFrameAllocationCount() const noexcept
+{
+    return m_FrameAllocationCount;
+}
+
+/// @brief set the amount of threads that rasterize the screen tiles of the software renderer
+/// @param threadCount total amount of threads, including the render thread, 1 rasterizes everything on the render thread
+void Renderer::SetSoftwareThreadCount(uint32_t threadCount)
+{
+    m_pTileWorkerPool = std::make_unique<TileWorkerPool>(std::max(threadCount , 1u));
+}
+
+/// @brief get the raster counters of the last software frame
+/// @return the summed counters of all tiles
+const software::RasterStats& Renderer::GetSoftwareRasterStats() const noexcept
+{
+    return m_RasterStats;
+}
+
+/// @brief pick how the software renderer shades
+/// @param mode Forward shades every fragment that passes the depth test, Deferred shades every visible pixel once
+void Renderer::SetSoftwareShadingMode(software::ShadingMode mode)
+{
+    m_ShadingMode = mode;
+}
+
+/// @brief shade low contrast 8x8 blocks once per 2x2 or 4x4 pixels and triangle in the deferred mode, off by default
+/// @brief the rate of a block is picked from the contrast the last frame shaded there, the depth test stays per pixel
+/// @param useVariableRateShading true to shade at the rate of the blocks, false to shade every visible pixel
+void Renderer::SetSoftwareVariableRateShading(bool useVariableRateShading)
+{
+    m_UseVariableRateShading = useVariableRateShading;
+
+    //the rates are stale by the time it gets turned on again, every block starts at the full rate
+    m_BlockShadingRates.clear();
+}
+
+/// @brief get how the software renderer shades
+/// @return the shading mode
+software::ShadingMode Renderer::GetSoftwareShadingMode() const noexcept
+{
+    return m_ShadingMode;
+}
+
+/// @brief hold the software frames under a frame time by lowering the internal resolution, the result is scaled up to the window
+/// @param milliseconds the frame time budget, 0 always renders at the window resolution
+/// @param minScale the smallest scale of the width and height
+/// @param maxScale the largest scale of the width and height
+void Renderer::SetSoftwareFrameBudget(float milliseconds , float minScale , float maxScale)
+{
+    m_DynamicResolution.SetScaleRange(minScale , maxScale);
+    m_DynamicResolution.SetBudget(milliseconds);
+}
+
+/// @brief get the controller of the internal resolution, for its scale and budget misses
+/// @return the dynamic resolution state of the software renderer
+const DynamicResolution& Renderer::GetSoftwareDynamicResolution() const noexcept
+{
+    return m_DynamicResolution;
+}
+
+/// @brief skip primitives hidden behind the depth of the previous frame, reprojected with the current camera
+/// @brief a primitive culled wrongly is found after its frame and drawn the next one, so it is never hidden for longer than a frame
+/// @param useOcclusionCulling true to test the primitives before their vertices get transformed
+void Renderer::SetSoftwareOcclusionCulling(bool useOcclusionCulling)
+{
+    m_UseOcclusionCulling = useOcclusionCulling;
+
+    //the captured depth is stale by the time it gets turned on again
+    if(!useOcclusionCulling) m_OcclusionCuller.Reset();
+}
+
+/// @brief get the map from ndc to the blocks of the hierarchical z buffer of the current frame
+/// @return the viewport the occlusion culler works in, one cell per block
+OcclusionViewport Renderer::GetHiZViewport()
+{
+    //NDCToRaster is affine, two corners give its scale and offset
+    FPoint4 corner0{-1.0f , -1.0f , 0.0f , 1.0f};
+    FPoint4 corner1{1.0f , 1.0f , 0.0f , 1.0f};
+    NDCToRaster(corner0);
+    NDCToRaster(corner1);
+
+    const float toCellX = m_RenderScaleX / float(software::BlockSize);
+    const float toCellY = m_RenderScaleY / float(software::BlockSize);
+    return OcclusionViewport
+    {
+        (corner1.x - corner0.x) * 0.5f * toCellX , (corner1.x + corner0.x) * 0.5f * toCellX,
+        (corner1.y - corner0.y) * 0.5f * toCellY , (corner1.y + corner0.y) * 0.5f * toCellY
+    };
+}
+
+/// @brief mark the primitives inside the frustum that the reprojected depth of the previous frame hides
+/// @param viewProjectionMatrix projection * view of the camera of this frame
+void Renderer::CullOccludedPrimitives(const FMatrix4& viewProjectionMatrix)
+{
+    SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageCulling);
+
+    m_OcclusionCuller.Reproject(viewProjectionMatrix , GetHiZViewport() , m_HiZWidth , m_HiZHeight);
+
+    for(size_t primitiveIndex = 0; primitiveIndex < m_IsPrimitiveVisible.size(); ++primitiveIndex)
+    {
+        if(!m_IsPrimitiveVisible[primitiveIndex]) continue;
+
+        //culled wrongly last frame, drawn without the test so its depth is there for the next one
+        if(m_IsOcclusionTestSkipped[primitiveIndex])
+        {
+            m_IsOcclusionTestSkipped[primitiveIndex] = 0;
+            continue;
+        }
+
+        m_IsPrimitiveOccluded[primitiveIndex] = m_OcclusionCuller.GetIsOccluded(m_SceneBVH.GetWorldBounds(primitiveIndex)) ? 1 : 0;
+    }
+}
+
+/// @brief hand the hierarchical z of the frame that was just rasterized to the occlusion culler
+/// @brief the primitives it culled this frame get tested against it, the ones it doesn't hide were false negatives
+/// @param viewProjectionMatrix projection * view of the camera of this frame
+void Renderer::CaptureOcclusionDepth(const FMatrix4& viewProjectionMatrix)
+{
+    SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageCulling);
 
-            //NDC to raster
-            NDCToRaster(vertex0);
-            NDCToRaster(vertex1);
-            NDCToRaster(vertex2);
+    m_OcclusionCuller.Capture(m_HiZBuffer , m_HiZWidth , m_HiZHeight , viewProjectionMatrix , GetHiZViewport());
 
-            const float areaParallelogram = Cross(FVector2(vertex2 - vertex0) , FVector2(vertex1 - vertex0));
+    for(size_t primitiveIndex = 0; primitiveIndex < m_IsPrimitiveOccluded.size(); ++primitiveIndex)
+    {
+        if(!m_IsPrimitiveOccluded[primitiveIndex] || m_OcclusionCuller.GetIsOccluded(m_SceneBVH.GetWorldBounds(primitiveIndex))) continue;
+
+        m_IsOcclusionTestSkipped[primitiveIndex] = 1;
+        SOFTWARE_STATS_ADD(m_PipelineStats , primitivesOcclusionFalseNegatives , 1);
+    }
+}
+
+/// @brief resolve the software frames straight into the window surface instead of the back buffer, saves the blit of every frame
+/// @brief a window surface the resolve can't write falls back to the back buffer and the blit
+/// @param usePresentDirect true to write the window surface when its format allows it
+void Renderer::SetSoftwarePresentDirect(bool usePresentDirect)
+{
+    m_UsePresentDirect = usePresentDirect;
+}
+
+/// @brief get the surface the software frame gets resolved into
+/// @return the window surface when presenting directly and it is a 32 bit surface of the window size, else the back buffer
+SDL_Surface* Renderer::GetPresentTarget()
+{
+    if(!m_pWindow || !m_UsePresentDirect) return m_pBackBuffer;
+
+    //a resize invalidates the window surface, SDL hands out the current one
+    m_pFrontBuffer = SDL_GetWindowSurface(m_pWindow);
+
+    //the resolve writes 32 bit pixels with any channel order, other formats need the conversion of the blit
+    const bool isWritable = m_pFrontBuffer && m_pFrontBuffer->format->BytesPerPixel == 4
+        && m_pFrontBuffer->w == static_cast<int>(m_Width) && m_pFrontBuffer->h == static_cast<int>(m_Height);
+    return isWritable ? m_pFrontBuffer : m_pBackBuffer;
+}
+
+/// @brief pick and lock the surface the next software frame gets resolved into
+/// @brief on the thread that created the window, the sdl video calls have to stay there while the render can run on another thread
+void Renderer::BeginSoftwarePresent()
+{
+    m_pPresentTarget = GetPresentTarget();
+    SDL_LockSurface(m_pPresentTarget);
+}
+
+/// @brief show the resolved software frame, on the thread that created the window once the render finished
+void Renderer::PresentSoftware()
+{
+    SOFTWARE_STATS_TIMER(m_RasterStats.pipeline , software::StagePresent);
+
+    SDL_UnlockSurface(m_pPresentTarget);
+    m_pPresentedSurface = m_pPresentTarget;
+
+    //headless, the back buffer is the output
+    if(m_pWindow)
+    {
+        if(m_pPresentTarget == m_pBackBuffer) SDL_BlitSurface(m_pBackBuffer , 0 , m_pFrontBuffer , 0);
+        SDL_UpdateWindowSurface(m_pWindow);
+    }
+}
+
+/// @brief pick the instruction set of the span rasterizer
+/// @param level the requested instruction set, lowered to the widest one the cpu supports, Scalar forces the fallback path
+void Renderer::SetRasterSimdLevel(software::SimdLevel level)
+{
+    m_SimdLevel = std::min(level , software::DetectSimdLevel());
+    m_RasterizeSpan = software::GetRasterizeSpanFunction(m_SimdLevel);
+}
+
+/// @brief get the object space streams of the mesh of a primitive, built the first time the mesh gets rendered
+/// @param primitive the primitive to get the streams of
+/// @return the streams, shared by every primitive with the same mesh
+const software::ObjectVertexStreams& Renderer::GetObjectVertexStreams(const Primitive* primitive)
+{
+    const auto& vertexBuffer = primitive->GetMesh()->pMeshData->vertexBufferSR;
+
+    auto it = m_ObjectVertexStreams.find(&vertexBuffer);
+    if(it == m_ObjectVertexStreams.end())
+    {
+        //a mesh that wasn't rendered before
+        it = m_ObjectVertexStreams.emplace(&vertexBuffer , software::ObjectVertexStreams{}).first;
+        software::BuildObjectVertexStreams(vertexBuffer , it->second);
+    }
+    return it->second;
+}
+
+/// @brief get the object space bounds of a primitive, for the scene bvh
+/// @param primitive the primitive to get the bounds of
+/// @return the box around the vertices of the mesh, around all instances for an instanced primitive
+BoundingBoxWorld Renderer::GetObjectBounds(const Primitive* primitive)
+{
+    const BoundingBoxWorld meshBounds = GetMeshBounds(primitive);
+
+    const InstancedPrimitive* const pInstanced = dynamic_cast<const InstancedPrimitive*>(primitive);
+    if(!pInstanced) return meshBounds;
+
+    BoundingBoxWorld bounds{{FLT_MAX , FLT_MAX , FLT_MAX} , {-FLT_MAX , -FLT_MAX , -FLT_MAX}};
+    for(const FMatrix4& instanceTransform : pInstanced->GetInstanceTransforms())
+    {
+        GrowBounds(bounds , TransformBounds(meshBounds , instanceTransform));
+    }
+    return bounds;
+}
+
+/// @brief get the object space bounds of the mesh of a primitive
+/// @param primitive the primitive to get the bounds of
+/// @return the box around the vertices of the mesh
+BoundingBoxWorld Renderer::GetMeshBounds(const Primitive* primitive)
+{
+    const software::ObjectVertexStreams& objectStreams = GetObjectVertexStreams(primitive);
+
+    BoundingBoxWorld bounds{{FLT_MAX , FLT_MAX , FLT_MAX} , {-FLT_MAX , -FLT_MAX , -FLT_MAX}};
+    for(size_t i = 0; i < objectStreams.vertexCount; ++i)
+    {
+        bounds.min.x = std::min(bounds.min.x , objectStreams.positionX[i]);
+        bounds.min.y = std::min(bounds.min.y , objectStreams.positionY[i]);
+        bounds.min.z = std::min(bounds.min.z , objectStreams.positionZ[i]);
+        bounds.max.x = std::max(bounds.max.x , objectStreams.positionX[i]);
+        bounds.max.y = std::max(bounds.max.y , objectStreams.positionY[i]);
+        bounds.max.z = std::max(bounds.max.z , objectStreams.positionZ[i]);
+    }
+    return bounds;
+}
+
+/// @brief set up the triangles of a primitive, once or once per instance for an instanced primitive
+/// @param primitive the primitive to process
+/// @param worldMatrix the world matrix of the primitive in the snapshot of the frame
+/// @param renderState the render state of the primitive in the snapshot of the frame
+/// @param transformedStreams gets the transformed vertices, allocated in the frame arena, reused by every instance
+void Renderer::SetupPrimitiveTriangles(Primitive* primitive , const FMatrix4& worldMatrix , const PrimitiveRenderState& renderState
+    , software::TransformedVertexStreams& transformedStreams)
+{
+    SOFTWARE_STATS_ADD(m_PipelineStats , draws , 1);
+
+    const InstancedPrimitive* const pInstanced = dynamic_cast<const InstancedPrimitive*>(primitive);
+    if(!pInstanced)
+    {
+        SetupInstanceTriangles(primitive , worldMatrix , renderState , transformedStreams);
+        return;
+    }
+
+    //the triangles of an instance are set up before the next one transforms, so they share the streams
+    for(const FMatrix4& instanceTransform : pInstanced->GetInstanceTransforms())
+    {
+        SetupInstanceTriangles(primitive , worldMatrix * instanceTransform , renderState , transformedStreams);
+    }
+}
+
+/// @brief cull the meshlets of the primitive, transform the vertices of the visible ones and set up their triangles
+/// @brief the object space data of the mesh is shared, per instance only the world matrix differs
+/// @param primitive the primitive to process
+/// @param worldMatrix the world matrix of the primitive or of one of its instances
+/// @param renderState the render state of the primitive in the snapshot of the frame
+/// @param transformedStreams gets the transformed vertices, allocated in the frame arena
+void Renderer::SetupInstanceTriangles(Primitive* primitive , const FMatrix4& worldMatrix , const PrimitiveRenderState& renderState
+    , software::TransformedVertexStreams& transformedStreams)
+{
+    const software::MeshletMesh& meshletMesh = GetMeshletMesh(primitive);
+    const std::vector<software::Meshlet>& meshlets = meshletMesh.meshlets;
+
+    const FMatrix4 worldViewProjectionMatrix = m_ViewProjectionMatrix * worldMatrix;
+
+    const std::span<uint32_t> visibleMeshlets = m_FrameArena.AllocateArray<uint32_t>(meshlets.size());
+    const std::span<software::VertexRange> vertexRanges = m_FrameArena.AllocateArray<software::VertexRange>(meshlets.size());
+    size_t visibleMeshletCount = 0;
+
+    //the state the triangle setup and raster kernels are specialized on, fixed for the whole primitive
+    //from the snapshot, the update can change the live primitive meanwhile
+    const ModelCullingMode cullMode = renderState.cullMode;
+    const uint8_t rasterState = (renderState.shouldWriteDepthBuffer ? software::RasterStateWriteDepth : 0)
+        | (renderState.shouldBlend ? software::RasterStateBlend : 0);
+
+    {
+        SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageCulling);
+
+        //cull in object space, no meshlet bounds need to be transformed
+        software::FrustumPlane planes[6];
+        software::ExtractFrustumPlanes(worldViewProjectionMatrix , planes);
 
-            //if any of the triangles, the 2 vectors are on top of each other 
-                                                //-> triangle doesn't exist -> go to next triangle
-            if(abs(areaParallelogram) < FLT_EPSILON) continue;
+        //the scene bvh only culls an instanced primitive as a whole, its instances get tested here
+        if(software::GetIsMeshOutsideFrustum(meshletMesh , planes))
+        {
+            SOFTWARE_STATS_ADD(m_PipelineStats , instancesFrustumCulled , 1);
+            return;
+        }
 
-            //culling, if area is under 0 -> backface culling 
-                                                // if area above 0, front face culling
+        const FMatrix4 inverseWorldViewProjection = Inverse(worldViewProjectionMatrix);
+        const FPoint3 cameraPosition = GetObjectSpaceCameraPosition(inverseWorldViewProjection);
+        const float frontFacingAreaSign = GetFrontFacingAreaSign(inverseWorldViewProjection , cameraPosition);
 
-            switch(primitive->GetModelCullMode())
+        for(uint32_t meshletIndex = 0; meshletIndex < meshlets.size(); ++meshletIndex)
+        {
+            const software::Meshlet& meshlet = meshlets[meshletIndex];
+
+            if(software::GetIsMeshletOutsideFrustum(meshlet , planes))
             {
+                SOFTWARE_STATS_ADD(m_PipelineStats , meshletsFrustumCulled , 1);
+                continue;
+            }
 
-                case ModelCullingMode::backface:
-                    if(areaParallelogram < 0.0f) continue;
-                    break;
-                case ModelCullingMode::frontface:
-                    if(areaParallelogram > 0.0f) continue;
-                    break;
-                case ModelCullingMode::noCulling:
-                      //do nothing
-                    break;
-                default:
-                      //do nothing
-                    break;
+            //the same culling as the triangles get, on the sign of the raster area every triangle of the meshlet would have
+            if(cullMode == ModelCullingMode::backface || cullMode == ModelCullingMode::frontface)
+            {
+                const software::MeshletFacing facing = software::GetMeshletFacing(meshlet , cameraPosition);
+                if(facing != software::MeshletFacing::Mixed)
+                {
+                    const float areaSign = (facing == software::MeshletFacing::Front) ? frontFacingAreaSign : -frontFacingAreaSign;
+                    if((cullMode == ModelCullingMode::backface && areaSign < 0.0f) || (cullMode == ModelCullingMode::frontface && areaSign > 0.0f))
+                    {
+                        SOFTWARE_STATS_ADD(m_PipelineStats , meshletsCullModeCulled , 1);
+                        continue;
+                    }
+                }
             }
 
+            visibleMeshlets[visibleMeshletCount] = meshletIndex;
+            vertexRanges[visibleMeshletCount] = software::VertexRange{meshlet.vertexOffset , meshlet.vertexCount};
+            ++visibleMeshletCount;
+        }
+    }
+
+    //every meshlet culled, no vertex to transform and no triangle to set up
+    if(visibleMeshletCount == 0) return;
+
+    //store resulting verts from transformations (world,camera,clip), only the vertices of the visible meshlets
+    {
+        SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageVertexTransform);
+        software::TransformVertexStreams(meshletMesh.streams , transformedStreams , m_FrameArena , worldMatrix
+            , worldViewProjectionMatrix , m_CameraPosition , m_SimdLevel , vertexRanges.first(visibleMeshletCount));
+    }
+
+    //dispatch once on the cull mode, the triangle loop has no state branches left
+    //the topology needs none, strips are turned into triangle lists when the meshlets are built
+    const std::span<const uint32_t> meshletsToSetup = visibleMeshlets.first(visibleMeshletCount);
+    switch(cullMode)
+    {
+        case ModelCullingMode::backface:
+            SetupMeshletTriangles<ModelCullingMode::backface>(primitive , meshletMesh , meshletsToSetup , transformedStreams , rasterState);
+            break;
+        case ModelCullingMode::frontface:
+            SetupMeshletTriangles<ModelCullingMode::frontface>(primitive , meshletMesh , meshletsToSetup , transformedStreams , rasterState);
+            break;
+        default:
+            SetupMeshletTriangles<ModelCullingMode::noCulling>(primitive , meshletMesh , meshletsToSetup , transformedStreams , rasterState);
+            break;
+    }
+}
+
+/// @brief set up every triangle of the visible meshlets of a primitive, specialized on the cull mode of the primitive
+/// @param primitive the primitive the meshlets belong to
+/// @param meshletMesh the meshlets of the mesh of the primitive
+/// @param visibleMeshlets the indices of the meshlets that survived culling
+/// @param transformedStreams the transformed vertices of the visible meshlets
+/// @param rasterState the RasterStateFlags of the primitive
+template<ModelCullingMode CullMode>
+void Renderer::SetupMeshletTriangles(Primitive* primitive , const software::MeshletMesh& meshletMesh , std::span<const uint32_t> visibleMeshlets
+    , const software::TransformedVertexStreams& transformedStreams , uint8_t rasterState)
+{
+    for(const uint32_t meshletIndex : visibleMeshlets)
+    {
+        const software::Meshlet& meshlet = meshletMesh.meshlets[meshletIndex];
+        const uint8_t* pLocalIndices = &meshletMesh.localIndices[size_t(meshlet.triangleOffset) * 3];
 
-            BoundingBoxTriangle boundingBox = GetBoundingBox(vertex0 , vertex1 , vertex2);
+        for(uint32_t triangleIndex = 0; triangleIndex < meshlet.triangleCount; ++triangleIndex)
+        {
+            SetupTriangle<CullMode>(primitive , transformedStreams , rasterState , meshlet.vertexOffset + pLocalIndices[triangleIndex * 3]
+                , meshlet.vertexOffset + pLocalIndices[triangleIndex * 3 + 1] , meshlet.vertexOffset + pLocalIndices[triangleIndex * 3 + 2]);
+        }
+    }
+}
+
+/// @brief clip a triangle of the transformed streams and set up the triangles that are left of it
+/// @param primitive the primitive the triangle belongs to
+/// @param transformedStreams the transformed vertices of the primitive
+/// @param rasterState the RasterStateFlags of the primitive
+/// @param index0 first vertex
+/// @param index1 second vertex
+/// @param index2 third vertex
+template<ModelCullingMode CullMode>
+void Renderer::SetupTriangle(Primitive* primitive , const software::TransformedVertexStreams& transformedStreams , uint8_t rasterState
+    , uint32_t index0 , uint32_t index1 , uint32_t index2)
+{
+    software::ClipVertex polygon[software::MaxClippedVertices];
+    uint32_t polygonVertexCount = 0;
+    {
+        SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageCulling);
+
+        //get 3 triangle verts in clip space
+        const software::ClipVertex triangle[3]{software::GatherClipVertex(transformedStreams , index0)
+            , software::GatherClipVertex(transformedStreams , index1) , software::GatherClipVertex(transformedStreams , index2)};
+
+        const uint32_t outcode0 = software::GetOutcode(triangle[0].position);
+        const uint32_t outcode1 = software::GetOutcode(triangle[1].position);
+        const uint32_t outcode2 = software::GetOutcode(triangle[2].position);
+
+        //all 3 verts outside the same frustum plane -> triangle can't be visible
+        constexpr uint32_t frustumPlanes = software::ClipNear | software::ClipFar | software::ClipLeft | software::ClipRight
+            | software::ClipBottom | software::ClipTop;
+        if(outcode0 & outcode1 & outcode2 & frustumPlanes)
+        {
+            SOFTWARE_STATS_ADD(m_PipelineStats , trianglesFrustumCulled , 1);
+            return;
+        }
+
+        //only clip against near, far and the guard band, crossing the frustum sides is handled by the clamped bounding box
+        //without planes to clip the triangle is copied as is
+        const uint32_t planesToClip = (outcode0 | outcode1 | outcode2) & software::ClipPlanesToClip;
+        polygonVertexCount = software::ClipTriangle(triangle , planesToClip , polygon);
+        if(polygonVertexCount < 3) SOFTWARE_STATS_ADD(m_PipelineStats , trianglesFrustumCulled , 1);
+    }
+
+    //fan the clipped polygon back into triangles
+    for(uint32_t v = 1; v + 1 < polygonVertexCount; ++v)
+    {
+        EmitRasterTriangle<CullMode>(primitive , rasterState , polygon[0] , polygon[v] , polygon[v + 1]);
+    }
+}
+
+/// @brief get the position of the camera in the space a world view projection matrix transforms from
+/// @param inverseWorldViewProjection the inverse of the world view projection matrix
+/// @return the point that ends up at x = y = w = 0 in clip space
+FPoint3 Renderer::GetObjectSpaceCameraPosition(const FMatrix4& inverseWorldViewProjection)
+{
+    const FMatrix4& m = inverseWorldViewProjection;
+    const float invW = 1.0f / m(3 , 2);
+    return FPoint3{m(0 , 2) * invW , m(1 , 2) * invW , m(2 , 2) * invW};
+}
+
+/// @brief get the sign of the raster area of triangles facing the camera, with the normal cross(v1 - v0 , v2 - v0) in object space
+/// @brief mirrored world matrices and the camera conventions flip it, so it is measured on a triangle in the middle of the screen
+/// @param inverseWorldViewProjection the inverse of the world view projection matrix
+/// @param cameraPosition the camera in object space
+/// @return 1 or -1
+float Renderer::GetFrontFacingAreaSign(const FMatrix4& inverseWorldViewProjection , const FPoint3& cameraPosition)
+{
+    const FMatrix4& m = inverseWorldViewProjection;
+
+    //a triangle in ndc, halfway the depth range
+    FPoint4 ndc[3]{FPoint4{0.0f , 0.0f , 0.5f , 1.0f} , FPoint4{0.5f , 0.0f , 0.5f , 1.0f} , FPoint4{0.0f , 0.5f , 0.5f , 1.0f}};
+
+    FVector3 object[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        float homogeneous[4];
+        for(int r = 0; r < 4; ++r) homogeneous[r] = m(r , 0) * ndc[i].x + m(r , 1) * ndc[i].y + m(r , 2) * ndc[i].z + m(r , 3) * ndc[i].w;
+        object[i] = FVector3{homogeneous[0] / homogeneous[3] , homogeneous[1] / homogeneous[3] , homogeneous[2] / homogeneous[3]};
+
+        NDCToRaster(ndc[i]);
+    }
 
-            //inverse depth vertex
-            const float vertex0InvDepth = 1.0f / vertex0.w;
-            const float vertex1InvDepth = 1.0f / vertex1.w;
-            const float vertex2InvDepth = 1.0f / vertex2.w;
+    const FVector3 toCamera{cameraPosition.x - object[0].x , cameraPosition.y - object[0].y , cameraPosition.z - object[0].z};
+    const bool isFacingCamera = Dot(Cross(object[1] - object[0] , object[2] - object[0]) , toCamera) > 0.0f;
 
-                              //loop over boundingbox
-            for(uint64_t r = static_cast<uint64_t>(boundingBox.topLeft.y); (int) r < boundingBox.bottomRight.y && r < m_Height; ++r)
+    //the area like the triangle setup calculates it
+    const float areaParallelogram = Cross(FVector2(ndc[2] - ndc[0]) , FVector2(ndc[1] - ndc[0]));
+    return ((areaParallelogram > 0.0f) == isFacingCamera) ? 1.0f : -1.0f;
+}
+
+/// @brief get the meshlets of the mesh of a primitive, built the first time the mesh gets rendered
+/// @param primitive the primitive to get the meshlets of
+/// @return the meshlets and their vertex streams, shared by every primitive with the same mesh
+const software::MeshletMesh& Renderer::GetMeshletMesh(const Primitive* primitive)
+{
+    const auto& indexBuffer = primitive->GetMesh()->pMeshData->indexBufferSR;
+
+    auto it = m_MeshletMeshes.find(&indexBuffer);
+    if(it == m_MeshletMeshes.end())
+    {
+        //a mesh that wasn't rendered before
+        it = m_MeshletMeshes.emplace(&indexBuffer , software::MeshletMesh{}).first;
+        software::BuildMeshlets(GetObjectVertexStreams(primitive) , indexBuffer
+            , primitive->GetTopology() == PrimitiveTopology::TriangleStrip , it->second);
+    }
+    return it->second;
+}
+
+/// @brief project a clip space triangle to raster space, cull it and store it for binning
+/// @param primitive the primitive the triangle belongs to
+/// @param rasterState the RasterStateFlags of the primitive
+/// @param vertex0 first vertex in clip space, inside the near, far and guard band planes
+/// @param vertex1 second vertex in clip space
+/// @param vertex2 third vertex in clip space
+template<ModelCullingMode CullMode>
+void Renderer::EmitRasterTriangle(Primitive* primitive , uint8_t rasterState , software::ClipVertex vertex0 , software::ClipVertex vertex1
+    , software::ClipVertex vertex2)
+{
+    SOFTWARE_STATS_TIMER(m_PipelineStats , software::StageTriangleSetup);
+
+    //perspective divide, w is kept for the perspective correct interpolation
+    for(software::ClipVertex* pVertex : {&vertex0 , &vertex1 , &vertex2})
+    {
+        FPoint4& position = pVertex->position;
+        const float invW = 1.0f / position.w;
+        position.x *= invW;
+        position.y *= invW;
+        position.z *= invW;
+
+        //NDC to raster, then to the internal resolution, snapped to the sub pixel grid of the fixed point edges
+        NDCToRaster(position);
+        position.x = software::SnapToSubPixel(position.x * m_RenderScaleX);
+        position.y = software::SnapToSubPixel(position.y * m_RenderScaleY);
+    }
+
+    const FPoint4& position0 = vertex0.position;
+    const FPoint4& position1 = vertex1.position;
+    const FPoint4& position2 = vertex2.position;
+
+    //exact on the snapped vertices, so a triangle is only degenerate when it has no area at all
+    const int64_t fixedPointArea = software::GetFixedPointArea(position0 , position1 , position2);
+    const float areaParallelogram = static_cast<float>(fixedPointArea) / float(software::SubPixelSteps * software::SubPixelSteps);
+
+    //if any of the triangles, the 2 vectors are on top of each other
+    //-> triangle doesn't exist -> go to next triangle
+    if(fixedPointArea == 0)
+    {
+        SOFTWARE_STATS_ADD(m_PipelineStats , trianglesDegenerate , 1);
+        return;
+    }
+
+    //culling, if area is under 0 -> backface culling
+    // if area above 0, front face culling
+    if((CullMode == ModelCullingMode::backface && areaParallelogram < 0.0f)
+        || (CullMode == ModelCullingMode::frontface && areaParallelogram > 0.0f))
+    {
+        SOFTWARE_STATS_ADD(m_PipelineStats , trianglesCullMode , 1);
+        return;
+    }
+
+    const BoundingBoxTriangle boundingBox = GetBoundingBox(position0 , position1 , position2);
+
+    //pixels the old bounding box loop visited: c < bottomRight.x and c < m_RenderWidth
+    //the guard band can put the box far off screen, clamping it is what replaces clipping against the side planes
+    const software::PixelRect pixelBounds
+    {
+        std::max(static_cast<int>(boundingBox.topLeft.x) , 0),
+        std::max(static_cast<int>(boundingBox.topLeft.y) , 0),
+        std::min(static_cast<int>(std::ceil(boundingBox.bottomRight.x)) - 1 , static_cast<int>(m_RenderWidth) - 1),
+        std::min(static_cast<int>(std::ceil(boundingBox.bottomRight.y)) - 1 , static_cast<int>(m_RenderHeight) - 1)
+    };
+
+    if(pixelBounds.right < pixelBounds.left || pixelBounds.bottom < pixelBounds.top)
+    {
+        SOFTWARE_STATS_ADD(m_PipelineStats , trianglesFrustumCulled , 1);
+        return;
+    }
+
+    //clipping can make more triangles than the index buffers hold, grow the array in the arena
+    if(m_RasterTriangleCount == m_RasterTriangles.size())
+    {
+        const std::span<software::RasterTriangle> grownTriangles
+            = m_FrameArena.AllocateArray<software::RasterTriangle>(std::max<size_t>(m_RasterTriangles.size() * 2 , 1024));
+        std::copy(m_RasterTriangles.begin() , m_RasterTriangles.end() , grownTriangles.begin());
+        m_RasterTriangles = grownTriangles;
+    }
+
+    software::RasterTriangle& triangle = m_RasterTriangles[m_RasterTriangleCount++];
+    triangle.pPrimitive = primitive;
+    triangle.rasterState = rasterState;
+    triangle.areaParallelogram = areaParallelogram;
+    triangle.nearestDepth = std::min(std::min(position0.z , position1.z) , position2.z);
+    triangle.edges = software::SetupTriangleEdges(position0 , position1 , position2 , areaParallelogram);
+    triangle.pixelBounds = pixelBounds;
+
+    //the attributes only get interpolated from here on, the vertices aren't kept
+    software::SetupAttributePlanes(triangle.edges , vertex0 , vertex1 , vertex2 , triangle.planes);
+}
+
+/// @brief rasterize all the triangles binned into a tile, in draw order
+/// @brief in the deferred mode the opaque triangles only write the visibility buffer, every visible pixel of the tile is shaded
+/// @brief once afterwards and the blended triangles are drawn forward on top
+/// @param tileIndex the index of the tile, row major
+void Renderer::RasterizeTile(uint32_t tileIndex)
+{
+    const int tileLeft = static_cast<int>((tileIndex % m_TilesX) * software::TileSize);
+    const int tileTop = static_cast<int>((tileIndex / m_TilesX) * software::TileSize);
+
+    const software::PixelRect tileRect
+    {
+        tileLeft,
+        tileTop,
+        std::min(tileLeft + static_cast<int>(software::TileSize) , static_cast<int>(m_RenderWidth)) - 1,
+        std::min(tileTop + static_cast<int>(software::TileSize) , static_cast<int>(m_RenderHeight)) - 1
+    };
+
+    if(m_ShadingMode == software::ShadingMode::Forward)
+    {
+        RasterizeTileBin(tileIndex , tileRect , software::RasterPass::Forward);
+        return;
+    }
+
+    ClearVisibilityTile(tileRect);
+    RasterizeTileBin(tileIndex , tileRect , software::RasterPass::Visibility);
+    if(m_UseVariableRateShading)
+    {
+        ShadeVisibilityTileCoarse(tileIndex , tileRect);
+        UpdateBlockShadingRates(tileRect);
+    }
+    else
+    {
+        ShadeVisibilityTile(tileIndex , tileRect);
+    }
+    RasterizeTileBin(tileIndex , tileRect , software::RasterPass::Blended);
+}
+
+/// @brief rasterize the triangles of a tile bin that belong to a pass
+/// @param tileIndex the index of the tile, row major
+/// @param tileRect the pixels of the tile
+/// @param pass Forward rasterizes every triangle, Visibility only the opaque ones and Blended only the blended ones
+void Renderer::RasterizeTileBin(uint32_t tileIndex , const software::PixelRect& tileRect , software::RasterPass pass)
+{
+    software::RasterStats& stats = m_TileRasterStats[tileIndex];
+
+    //farthest depth of the whole tile, only recalculated after a block of the tile got closer
+    //starts dirty, a previous pass of the same tile can already have written depth
+    float tileFarDepth = FLT_MAX;
+    bool isTileFarDepthDirty = true;
+
+    for(uint32_t binIndex = m_TileBinOffsets[tileIndex]; binIndex < m_TileBinOffsets[tileIndex + 1]; ++binIndex)
+    {
+        const uint32_t triangleIndex = m_TileBinTriangles[binIndex];
+        const software::RasterTriangle& triangle = m_RasterTriangles[triangleIndex];
+
+        if(pass != software::RasterPass::Forward
+            && ((triangle.rasterState & software::RasterStateBlend) != 0) != (pass == software::RasterPass::Blended)) continue;
+
+        if(isTileFarDepthDirty)
+        {
+            tileFarDepth = GetHiZFarDepth(tileRect);
+            isTileFarDepthDirty = false;
+        }
+
+        //the whole triangle is behind everything in this tile
+        if(triangle.nearestDepth >= tileFarDepth)
+        {
+            ++stats.trianglesOccluded;
+            continue;
+        }
+
+        if(RasterizeTriangle(triangleIndex , software::GetIntersection(triangle.pixelBounds , tileRect) , stats , pass))
+        {
+            isTileFarDepthDirty = true;
+        }
+    }
+}
+
+/// @brief mark every pixel of a tile as not covered in the visibility buffer
+/// @param tileRect the pixels of the tile
+void Renderer::ClearVisibilityTile(const software::PixelRect& tileRect)
+{
+    const software::VisibilitySample emptySample{software::InvalidTriangleIndex , 0.0f , 0.0f , 0.0f};
+    for(int r = tileRect.top; r <= tileRect.bottom; ++r)
+    {
+        software::VisibilitySample* const pRow = &m_VisibilityBuffer[size_t(r) * m_RenderWidth];
+        std::fill(pRow + tileRect.left , pRow + tileRect.right + 1 , emptySample);
+    }
+}
+
+/// @brief shade every pixel of a tile that an opaque triangle is visible in, row by row
+/// @param tileIndex the index of the tile, row major
+/// @param tileRect the pixels of the tile
+void Renderer::ShadeVisibilityTile(uint32_t tileIndex , const software::PixelRect& tileRect)
+{
+    software::RasterStats& stats = m_TileRasterStats[tileIndex];
+    SOFTWARE_STATS_TIMER(stats.pipeline , software::StageShading);
+
+    for(int r = tileRect.top; r <= tileRect.bottom; ++r)
+    {
+        const software::VisibilitySample* const pRow = &m_VisibilityBuffer[size_t(r) * m_RenderWidth];
+        for(int c = tileRect.left; c <= tileRect.right; ++c)
+        {
+            const software::VisibilitySample& sample = pRow[c];
+            if(sample.triangleIndex == software::InvalidTriangleIndex) continue;
+
+            const software::RasterTriangle& triangle = m_RasterTriangles[sample.triangleIndex];
+
+            //the depth of the fragment, the depth buffer only has it when the primitive writes depth
+            const float depth = sample.weight0 * triangle.edges.vertex0Z + sample.weight1 * triangle.edges.vertex1Z
+                + sample.weight2 * triangle.edges.vertex2Z;
+
+            //only opaque triangles are in the visibility buffer
+            ShadePixel<software::RasterStateWriteDepth>(triangle , static_cast<uint32_t>(c) , static_cast<uint32_t>(r) , depth);
+            ++stats.pixelsShaded;
+        }
+    }
+}
+
+/// @brief shade the visible pixels of a tile at the rate of their 8x8 block, for the variable rate shading
+/// @param tileIndex the index of the tile, row major
+/// @param tileRect the pixels of the tile, aligned on blocks
+void Renderer::ShadeVisibilityTileCoarse(uint32_t tileIndex , const software::PixelRect& tileRect)
+{
+    software::RasterStats& stats = m_TileRasterStats[tileIndex];
+    SOFTWARE_STATS_TIMER(stats.pipeline , software::StageShading);
+
+    for(int blockTop = tileRect.top; blockTop <= tileRect.bottom; blockTop += software::BlockSize)
+    {
+        for(int blockLeft = tileRect.left; blockLeft <= tileRect.right; blockLeft += software::BlockSize)
+        {
+            const size_t blockIndex = size_t(blockTop / software::BlockSize) * m_HiZWidth + blockLeft / software::BlockSize;
+            const int coarseSize = 1 << static_cast<int>(m_BlockShadingRates[blockIndex]);
+
+            const int blockRight = std::min(blockLeft + software::BlockSize - 1 , tileRect.right);
+            const int blockBottom = std::min(blockTop + software::BlockSize - 1 , tileRect.bottom);
+            for(int coarseTop = blockTop; coarseTop <= blockBottom; coarseTop += coarseSize)
             {
-                for(uint64_t c = static_cast<uint64_t>(boundingBox.topLeft.x); (int) c < boundingBox.bottomRight.x && c < m_Width; ++c)
+                for(int coarseLeft = blockLeft; coarseLeft <= blockRight; coarseLeft += coarseSize)
                 {
-                    const FPoint2 pixel = FPoint2((float) c , (float) r);
+                    const software::PixelRect coarseRect{coarseLeft , coarseTop , std::min(coarseLeft + coarseSize - 1 , blockRight)
+                        , std::min(coarseTop + coarseSize - 1 , blockBottom)};
+                    ShadeCoarsePixels(coarseRect , stats);
+                }
+            }
+        }
+    }
+}
 
-                    //get sign of each side to check wither pixel is on triangle
-                    float weight0 = GetWeight(vertex1 , vertex2 , pixel);
-                    float weight1 = GetWeight(vertex2 , vertex0 , pixel);
-                    float weight2 = GetWeight(vertex0 , vertex1 , pixel);
+/// @brief shade a coarse block of the visibility buffer once per triangle covering it, at the first pixel of the triangle
+/// @brief the other pixels of the triangle get its color, so the block never bleeds a color over a triangle edge
+/// @param coarseRect the pixels of the block, at most 4x4
+/// @param stats the raster counters of the current tile
+void Renderer::ShadeCoarsePixels(const software::PixelRect& coarseRect , software::RasterStats& stats)
+{
+    //one bit per pixel of the block, row major, set once it has its color
+    uint32_t shadedMask = 0;
+    const int width = coarseRect.right - coarseRect.left + 1;
 
-                    //check if inside triangle
-                    if((weight0 * areaParallelogram < 0.0f || weight1 * areaParallelogram < 0.0f || weight2 * areaParallelogram < 0.0f)) continue;
+    for(int r = coarseRect.top; r <= coarseRect.bottom; ++r)
+    {
+        for(int c = coarseRect.left; c <= coarseRect.right; ++c)
+        {
+            const uint32_t bit = 1u << ((r - coarseRect.top) * width + (c - coarseRect.left));
+            if(shadedMask & bit) continue;
 
-                    //get barycentric coordinates
-                    weight0 /= areaParallelogram;
-                    weight1 /= areaParallelogram;
-                    weight2 /= areaParallelogram;
+            const size_t pixelIndex = size_t(r) * m_RenderWidth + c;
+            const software::VisibilitySample& sample = m_VisibilityBuffer[pixelIndex];
+            if(sample.triangleIndex == software::InvalidTriangleIndex) continue;
 
-                                                  //get inverse interpolated zBuffer
-                    const float zBuffer =
-                        1 / (
-                            (1.0f / vertex0.z * weight0) +
-                            (1.0f / vertex1.z * weight1) +
-                            (1.0f / vertex2.z * weight2));
+            const software::RasterTriangle& triangle = m_RasterTriangles[sample.triangleIndex];
+            const float depth = sample.weight0 * triangle.edges.vertex0Z + sample.weight1 * triangle.edges.vertex1Z
+                + sample.weight2 * triangle.edges.vertex2Z;
 
-                    if(zBuffer > 1.0f || zBuffer < 0.0f) continue;
+            ShadePixel<software::RasterStateWriteDepth>(triangle , static_cast<uint32_t>(c) , static_cast<uint32_t>(r) , depth);
+            ++stats.pixelsShaded;
 
-                    //check if new depth value is closer to camera
-                    if((zBuffer >= m_DepthBuffer[c + static_cast<uint64_t>(r * static_cast<uint64_t>(m_Width))])) continue;
+            //the rest of the block on the same triangle, every pixel after this one
+            const float* const pColor = &m_ColorBuffer[pixelIndex * 4];
+            for(int otherR = r; otherR <= coarseRect.bottom; ++otherR)
+            {
+                for(int otherC = coarseRect.left; otherC <= coarseRect.right; ++otherC)
+                {
+                    const uint32_t otherBit = 1u << ((otherR - coarseRect.top) * width + (otherC - coarseRect.left));
+                    if(otherBit <= bit || (shadedMask & otherBit)) continue;
 
-                    if(primitive->GetShouldWriteDepthBuffer())
-                    {
-                          //write to depth buffer
-                        m_DepthBuffer[static_cast<uint64_t>(c + static_cast<uint64_t>(r * static_cast<uint64_t>(m_Width)))] = zBuffer;
-                    }
+                    const size_t otherIndex = size_t(otherR) * m_RenderWidth + otherC;
+                    if(m_VisibilityBuffer[otherIndex].triangleIndex != sample.triangleIndex) continue;
 
-                    const float vertex0InvDepthMULWeight0{vertex0InvDepth * weight0};
-                    const float vertex1InvDepthMULWeight1{vertex1InvDepth * weight1};
-                    const float vertex2InvDepthMULWeight2{vertex2InvDepth * weight2};
-
-                    //interpolate w value
-                    const float wInterpolated = 1.0f / (vertex0InvDepthMULWeight0 + vertex1InvDepthMULWeight1 + vertex2InvDepthMULWeight2);
-
-                    //interpolate uv, normal, tangent and view direction (templated function)
-                    Interpolate
-                    (
-                        vertexOUT
-                        , vertex0InvDepthMULWeight0
-                        , vertex1InvDepthMULWeight1
-                        , vertex2InvDepthMULWeight2
-                        , wInterpolated
-                        , transformedVertices[index0]
-                        , transformedVertices[index1]
-                        , transformedVertices[index2]
-                    );
-                    //output vertex
-                    vertexOUT.position = FPoint4(pixel , zBuffer , wInterpolated);
-
-                    //Get color from backbuffer to blend
-                    if(primitive->GetShouldBlend())
-                    {
-                        SDL_Color colorRGB;
-                        uint32_t pixelBlend = *(static_cast<uint32_t*>(m_pBackBuffer->pixels)
-                            + static_cast<uint64_t>(r * static_cast<uint64_t>(m_pBackBuffer->w) + c));
-                        SDL_GetRGB(pixelBlend , m_pBackBuffer->format , &colorRGB.r , &colorRGB.g , &colorRGB.b);
-                        targetColor = RGBColor(colorRGB.r / 255.0f , colorRGB.g / 255.0f , colorRGB.b / 255.0f);
-                    }
-                    CalculatePixelColor(vertexOUT , vertexOUT.color , primitive , targetColor
-                        , m_DepthBuffer[c + (r * static_cast<uint64_t>(m_Width))]);
-                    SetBackBufferPixels((uint32_t) vertexOUT.position.x ,
-                        (uint32_t) vertexOUT.position.y , vertexOUT.color);
+                    std::copy(pColor , pColor + 3 , &m_ColorBuffer[otherIndex * 4]);
+                    shadedMask |= otherBit;
+                    ++stats.pixelsCoarseShaded;
                 }
             }
         }
+    }
+}
 
+/// @brief pick the shading rate of the next frame for the 8x8 blocks of a tile, from the colors this frame shaded
+/// @brief the contrast is measured between pixels 4 apart, those are shaded at every rate so a coarse block doesn't look flat
+/// @brief a block only lags a frame behind when its contents change, the blended primitives don't count, they shade at the full rate
+/// @param tileRect the pixels of the tile, aligned on blocks
+void Renderer::UpdateBlockShadingRates(const software::PixelRect& tileRect)
+{
+    constexpr int SampleSpacing{4};
+
+    for(int blockTop = tileRect.top; blockTop <= tileRect.bottom; blockTop += software::BlockSize)
+    {
+        for(int blockLeft = tileRect.left; blockLeft <= tileRect.right; blockLeft += software::BlockSize)
+        {
+            float minLuminance = FLT_MAX;
+            float maxLuminance = -FLT_MAX;
+            for(int r = blockTop; r <= std::min(blockTop + software::BlockSize - 1 , tileRect.bottom); r += SampleSpacing)
+            {
+                for(int c = blockLeft; c <= std::min(blockLeft + software::BlockSize - 1 , tileRect.right); c += SampleSpacing)
+                {
+                    const size_t pixelIndex = size_t(r) * m_RenderWidth + c;
+                    if(m_VisibilityBuffer[pixelIndex].triangleIndex == software::InvalidTriangleIndex) continue;
+
+                    //as it ends up on screen, the resolve clamps
+                    const float* const pColor = &m_ColorBuffer[pixelIndex * 4];
+                    const float luminance = 0.2126f * std::clamp(pColor[0] , 0.0f , 1.0f) + 0.7152f * std::clamp(pColor[1] , 0.0f , 1.0f)
+                        + 0.0722f * std::clamp(pColor[2] , 0.0f , 1.0f);
+                    minLuminance = std::min(minLuminance , luminance);
+                    maxLuminance = std::max(maxLuminance , luminance);
+                }
+            }
+
+            //nothing visible, shading nothing is the same at every rate
+            const float contrast = (maxLuminance >= minLuminance) ? maxLuminance - minLuminance : 0.0f;
+
+            software::ShadingRate& rate = m_BlockShadingRates[size_t(blockTop / software::BlockSize) * m_HiZWidth + blockLeft / software::BlockSize];
+            if(contrast <= software::Coarse4x4MaxContrast) rate = software::ShadingRate::Coarse4x4;
+            else if(contrast <= software::Coarse2x2MaxContrast) rate = software::ShadingRate::Coarse2x2;
+            else rate = software::ShadingRate::Full;
+        }
     }
+}
+
+/// @brief get the farthest depth of the hierarchical z blocks overlapping a rectangle
+/// @param pixelRect the pixels to check, aligned to blocks or not
+/// @return the largest depth in the rectangle, no pixel in it is farther away
+float Renderer::GetHiZFarDepth(const software::PixelRect& pixelRect) const
+{
+    float farDepth = 0.0f;
+    for(int blockY = pixelRect.top / software::BlockSize; blockY <= pixelRect.bottom / software::BlockSize; ++blockY)
+    {
+        for(int blockX = pixelRect.left / software::BlockSize; blockX <= pixelRect.right / software::BlockSize; ++blockX)
+        {
+            farDepth = std::max(farDepth , m_HiZBuffer[size_t(blockY) * m_HiZWidth + blockX]);
+        }
+    }
+    return farDepth;
+}
+
+/// @brief recalculate the farthest depth of a hierarchical z block after pixels of it were written
+/// @param blockX column of the block
+/// @param blockY row of the block
+void Renderer::UpdateHiZBlock(int blockX , int blockY)
+{
+    const int left = blockX * software::BlockSize;
+    const int top = blockY * software::BlockSize;
+    const int right = std::min(left + software::BlockSize , static_cast<int>(m_RenderWidth));
+    const int bottom = std::min(top + software::BlockSize , static_cast<int>(m_RenderHeight));
+
+    float farDepth = 0.0f;
+    for(int r = top; r < bottom; ++r)
+    {
+        const float* pDepthRow = &m_DepthBuffer[size_t(r) * m_RenderWidth];
+        for(int c = left; c < right; ++c)
+        {
+            farDepth = std::max(farDepth , pDepthRow[c]);
+        }
+    }
+    m_HiZBuffer[size_t(blockY) * m_HiZWidth + blockX] = farDepth;
+}
+
+/// @brief rasterize the pixels of a triangle inside the given rectangle
+/// @param triangleIndex the index of the set up triangle from the geometry stage
+/// @param pixelRect the part of the triangle's bounding box that belongs to the current tile
+/// @param stats the raster counters of the current tile
+/// @param pass the Visibility pass writes the visibility buffer, the other passes shade
+/// @return true if the triangle wrote to the depth buffer
+bool Renderer::RasterizeTriangle(uint32_t triangleIndex , const software::PixelRect& pixelRect , software::RasterStats& stats
+    , software::RasterPass pass)
+{
+    const software::RasterTriangle& triangle = m_RasterTriangles[triangleIndex];
+    const RasterizeBlockFunction rasterizeBlock = GetRasterizeBlockFunction(pass , triangle.rasterState);
+    bool hasWrittenDepth = false;
+
+    //walk the 8x8 blocks, tiles are aligned on blocks so only the bounding box clips them
+    for(int blockTop = pixelRect.top - pixelRect.top % software::BlockSize; blockTop <= pixelRect.bottom; blockTop += software::BlockSize)
+    {
+        for(int blockLeft = pixelRect.left - pixelRect.left % software::BlockSize; blockLeft <= pixelRect.right; blockLeft += software::BlockSize)
+        {
+            const int blockX = blockLeft / software::BlockSize;
+            const int blockY = blockTop / software::BlockSize;
+
+            //early occlusion rejection, every pixel of the triangle in this block would fail the depth test
+            if(triangle.nearestDepth >= m_HiZBuffer[size_t(blockY) * m_HiZWidth + blockX])
+            {
+                ++stats.blocksOccluded;
+                continue;
+            }
+
+            const software::PixelRect block = software::GetIntersection(pixelRect
+                , software::PixelRect{blockLeft , blockTop , blockLeft + software::BlockSize - 1 , blockTop + software::BlockSize - 1});
+
+            //trivial reject or accept of the whole block
+            const software::BlockCoverage coverage = software::ClassifyBlock(triangle.edges , block.left , block.top , block.right , block.bottom);
+            if(coverage == software::BlockCoverage::Outside)
+            {
+                ++stats.blocksRejected;
+                continue;
+            }
+
+            if(coverage == software::BlockCoverage::Inside) ++stats.blocksAccepted;
+            else ++stats.blocksPartial;
+
+            //keep the farthest depth of the block up to date for the next triangles
+            if((this->*rasterizeBlock)(triangleIndex , block , coverage == software::BlockCoverage::Partial , stats))
+            {
+                UpdateHiZBlock(blockX , blockY);
+                hasWrittenDepth = true;
+            }
+        }
+    }
+    return hasWrittenDepth;
+}
+
+/// @brief get the raster kernel for a pass and the state of a triangle, every combination is instantiated at compile time
+/// @param pass the raster pass of the tile
+/// @param rasterState the RasterStateFlags of the triangle
+/// @return the specialized kernel, or the runtime one when SetUseRuntimeRasterKernels turned it on
+Renderer::RasterizeBlockFunction Renderer::GetRasterizeBlockFunction(software::RasterPass pass , uint8_t rasterState) const
+{
+    using software::RasterPass;
+    constexpr uint8_t depth = software::RasterStateWriteDepth;
+    constexpr uint8_t blend = software::RasterStateBlend;
+    constexpr uint8_t runtime = software::RasterStateRuntime;
+
+    //per pass, indexed on the state, the runtime kernel last
+    static constexpr RasterizeBlockFunction kernels[3][software::RasterStateCount + 1]
+    {
+        {
+            &Renderer::RasterizeBlock<0 , RasterPass::Forward> , &Renderer::RasterizeBlock<depth , RasterPass::Forward>
+            , &Renderer::RasterizeBlock<blend , RasterPass::Forward> , &Renderer::RasterizeBlock<depth | blend , RasterPass::Forward>
+            , &Renderer::RasterizeBlock<runtime , RasterPass::Forward>
+        },
+        {
+            &Renderer::RasterizeBlock<0 , RasterPass::Visibility> , &Renderer::RasterizeBlock<depth , RasterPass::Visibility>
+            , &Renderer::RasterizeBlock<blend , RasterPass::Visibility> , &Renderer::RasterizeBlock<depth | blend , RasterPass::Visibility>
+            , &Renderer::RasterizeBlock<runtime , RasterPass::Visibility>
+        },
+        {
+            &Renderer::RasterizeBlock<0 , RasterPass::Blended> , &Renderer::RasterizeBlock<depth , RasterPass::Blended>
+            , &Renderer::RasterizeBlock<blend , RasterPass::Blended> , &Renderer::RasterizeBlock<depth | blend , RasterPass::Blended>
+            , &Renderer::RasterizeBlock<runtime , RasterPass::Blended>
+        }
+    };
+    return kernels[static_cast<int>(pass)][m_UseRuntimeRasterKernels ? runtime : rasterState];
+}
+
+/// @brief use the runtime raster kernel for every triangle, it reads the state of the triangle in its loops, to measure the specialized ones against
+/// @param useRuntimeKernels false, the default, for the kernels specialized on the state of the triangle
+void Renderer::SetUseRuntimeRasterKernels(bool useRuntimeKernels)
+{
+    m_UseRuntimeRasterKernels = useRuntimeKernels;
+}
+
+/// @brief rasterize the pixels of a block of a triangle, shading them or writing them to the visibility buffer
+/// @brief specialized on the pass and the state of the primitive, RasterStateRuntime reads the state of the triangle instead
+/// @param triangleIndex the index of the set up triangle from the geometry stage
+/// @param block the pixels of the block inside the triangle's bounding box and the current tile
+/// @param testCoverage false if the block is fully inside the triangle and the edge tests can be skipped
+/// @param stats the raster counters of the current tile
+/// @return true if a pixel of the block was written to the depth buffer
+template<uint8_t RasterState , software::RasterPass Pass>
+bool Renderer::RasterizeBlock(uint32_t triangleIndex , const software::PixelRect& block , bool testCoverage
+    , software::RasterStats& stats)
+{
+    software::RasterFragment fragments[software::BlockSize];
 
-    //reset depth buffer
-    m_DepthBuffer.clear();
-    m_DepthBuffer = std::vector<float>(size_t(m_Width) * m_Height , FLT_MAX);
+    const software::RasterTriangle& triangle = m_RasterTriangles[triangleIndex];
 
-    SDL_UnlockSurface(m_pBackBuffer);
-    SDL_BlitSurface(m_pBackBuffer , 0 , m_pFrontBuffer , 0);
-    SDL_UpdateWindowSurface(m_pWindow);
-}
\ No newline at end of file
+    const int spanWidth = block.right - block.left + 1;
+    const bool shouldWriteDepth = software::GetHasRasterState<RasterState>(triangle.rasterState , software::RasterStateWriteDepth);
+    bool hasWrittenDepth = false;
+
+    //one span per row of the block
+    for(uint64_t r = static_cast<uint64_t>(block.top); (int) r <= block.bottom; ++r)
+    {
+        const uint64_t rowOffset = r * static_cast<uint64_t>(m_RenderWidth);
+
+        //covered pixels that pass the depth test, with their barycentric coordinates
+        uint32_t fragmentCount = 0;
+        {
+            SOFTWARE_STATS_TIMER(stats.pipeline , software::StageRaster);
+            fragmentCount = m_RasterizeSpan(triangle.edges , block.left , static_cast<int>(r) , spanWidth
+                , &m_DepthBuffer[rowOffset + block.left] , fragments , testCoverage);
+        }
+
+        SOFTWARE_STATS_CODE
+        (
+            const uint32_t coveredCount = testCoverage
+                ? software::CountSpanCoverage(triangle.edges , block.left , static_cast<int>(r) , spanWidth) : uint32_t(spanWidth);
+            stats.pipeline.pixelsTested += coveredCount;
+            stats.pipeline.pixelsDepthRejected += coveredCount - fragmentCount;
+        )
+
+        SOFTWARE_STATS_TIMER(stats.pipeline , Pass == software::RasterPass::Visibility ? software::StageRaster : software::StageShading);
+        for(uint32_t f = 0; f < fragmentCount; ++f)
+        {
+            const software::RasterFragment& fragment = fragments[f];
+            const uint64_t c = fragment.x;
+
+            //every fragment that passes the depth test, shaded now or in the visibility pass
+            SOFTWARE_STATS_CODE(++m_OverdrawBuffer[c + rowOffset]);
+
+            if(shouldWriteDepth)
+            {
+                //write to depth buffer
+                m_DepthBuffer[c + rowOffset] = fragment.depth;
+                hasWrittenDepth = true;
+            }
+
+            if constexpr(Pass == software::RasterPass::Visibility)
+            {
+                //the last triangle passing the depth test is the visible one, shaded once after the tile is done
+                m_VisibilityBuffer[c + rowOffset] = software::VisibilitySample{triangleIndex , fragment.weight0 , fragment.weight1 , fragment.weight2};
+            }
+            else
+            {
+                ShadePixel<RasterState>(triangle , static_cast<uint32_t>(c) , static_cast<uint32_t>(r) , fragment.depth);
+                ++stats.pixelsShaded;
+            }
+        }
+    }
+    return hasWrittenDepth;
+}
+
+/// @brief interpolate the attributes of a triangle at a pixel and shade it into the back buffer
+/// @param triangle the set up triangle from the geometry stage
+/// @param x column of the pixel
+/// @param y row of the pixel
+/// @param depth the depth of the triangle at the pixel
+template<uint8_t RasterState>
+void Renderer::ShadePixel(const software::RasterTriangle& triangle , uint32_t x , uint32_t y , float depth)
+{
+    RGBColor targetColor;
+    software::VS_OUTPUT vertexOUT;
+
+    Primitive* const primitive = triangle.pPrimitive;
+    const uint64_t pixelIndex = uint64_t(y) * m_RenderWidth + x;
+
+    //interpolate uv, normal, tangent and view direction from the planes of the triangle (templated function)
+    const float wInterpolated = software::InterpolateAttributes(vertexOUT , triangle , x , y);
+    //output vertex
+    vertexOUT.position = FPoint4(FPoint2((float) x , (float) y) , depth , wInterpolated);
+
+    float* const pColor = &m_ColorBuffer[pixelIndex * 4];
+
+    //Get color from the linear color buffer to blend
+    if(software::GetHasRasterState<RasterState>(triangle.rasterState , software::RasterStateBlend)) targetColor = RGBColor(pColor[0] , pColor[1] , pColor[2]);
+
+    CalculatePixelColor(vertexOUT , vertexOUT.color , primitive , targetColor
+        , m_DepthBuffer[pixelIndex]);
+
+    //unclamped, the resolve clamps and applies the gamma
+    pColor[0] = vertexOUT.color.r;
+    pColor[1] = vertexOUT.color.g;
+    pColor[2] = vertexOUT.color.b;
+}
+
+/// @brief convert the linear color buffer to a surface with the gamma of the game manager, the rows in parallel
+/// @brief below full resolution it gets scaled up bilinearly to the size of the surface
+/// @param pTarget the back buffer or the window surface, locked, 32 bit and the size of the window
+void Renderer::ResolveColorBuffer(SDL_Surface* pTarget)
+{
+    const float gamma = GameManager::GetInstance()->GetGammaValue();
+    if(m_ColorResolveTable.gamma != gamma) software::BuildColorResolveTable(gamma , m_ColorResolveTable);
+
+    const SDL_PixelFormat* const pFormat = pTarget->format;
+    const software::PixelLayout layout{pFormat->Rshift , pFormat->Gshift , pFormat->Bshift , pFormat->Amask};
+
+    //one band of rows per tile row
+    if(m_RenderWidth == m_Width && m_RenderHeight == m_Height)
+    {
+        m_pTileWorkerPool->Run(m_TilesY , [this , pTarget , &layout](uint32_t tileY)
+        {
+            const uint32_t top = tileY * software::TileSize;
+            const uint32_t bottom = std::min(top + software::TileSize , m_Height);
+            for(uint32_t r = top; r < bottom; ++r)
+            {
+                uint32_t* const pRow = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pTarget->pixels) + size_t(r) * pTarget->pitch);
+                software::ResolveColorRow(&m_ColorBuffer[size_t(r) * m_Width * 4] , pRow , m_Width , m_ColorResolveTable , layout);
+            }
+        });
+        return;
+    }
+
+    //a lower internal resolution, resolved at that resolution first and then scaled up to the back buffer
+    const std::span<uint32_t> scaledPixels = m_FrameArena.AllocateArray<uint32_t>(size_t(m_RenderWidth) * m_RenderHeight);
+    m_pTileWorkerPool->Run(m_TilesY , [this , &layout , scaledPixels](uint32_t tileY)
+    {
+        const uint32_t top = tileY * software::TileSize;
+        const uint32_t bottom = std::min(top + software::TileSize , m_RenderHeight);
+        for(uint32_t r = top; r < bottom; ++r)
+        {
+            software::ResolveColorRow(&m_ColorBuffer[size_t(r) * m_RenderWidth * 4] , &scaledPixels[size_t(r) * m_RenderWidth] , m_RenderWidth
+                , m_ColorResolveTable , layout);
+        }
+    });
+
+    const std::span<software::UpscaleColumn> columns = m_FrameArena.AllocateArray<software::UpscaleColumn>(m_Width);
+    software::BuildUpscaleColumns(m_RenderWidth , columns.data() , m_Width);
+
+    const uint32_t bandCount = (m_Height + software::TileSize - 1) / software::TileSize;
+    m_pTileWorkerPool->Run(bandCount , [this , pTarget , scaledPixels , columns](uint32_t band)
+    {
+        const uint32_t top = band * software::TileSize;
+        const uint32_t bottom = std::min(top + software::TileSize , m_Height);
+        for(uint32_t r = top; r < bottom; ++r)
+        {
+            const software::UpscaleRow row = software::GetUpscaleRow(m_RenderHeight , m_Height , r);
+            uint32_t* const pRow = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pTarget->pixels) + size_t(r) * pTarget->pitch);
+            software::UpscaleRowBilinear(&scaledPixels[size_t(row.sourceY) * m_RenderWidth] , &scaledPixels[size_t(row.sourceYBelow) * m_RenderWidth]
+                , row.weight , columns.data() , pRow , m_Width);
+        }
+    });
+}
@@ -0,0 +1,251 @@
+#include "SceneBVH.h"
+
+// - Project includes -
+#include "Frustum.h"
+
+// - Standard includes -
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+/// @brief transform an object space box and get the world space box around it (Arvo)
+BoundingBoxWorld TransformBounds(const BoundingBoxWorld& bounds , const Elite::FMatrix4& worldMatrix)
+{
+    const float center[3]{(bounds.min.x + bounds.max.x) * 0.5f , (bounds.min.y + bounds.max.y) * 0.5f , (bounds.min.z + bounds.max.z) * 0.5f};
+    const float extent[3]{(bounds.max.x - bounds.min.x) * 0.5f , (bounds.max.y - bounds.min.y) * 0.5f , (bounds.max.z - bounds.min.z) * 0.5f};
+
+    float worldCenter[3];
+    float worldExtent[3];
+    for(int r = 0; r < 3; ++r)
+    {
+        worldCenter[r] = worldMatrix(r , 3);
+        worldExtent[r] = 0.0f;
+        for(int c = 0; c < 3; ++c)
+        {
+            worldCenter[r] += worldMatrix(r , c) * center[c];
+            worldExtent[r] += std::abs(worldMatrix(r , c)) * extent[c];
+        }
+    }
+
+    return BoundingBoxWorld
+    {
+        Elite::FPoint3{worldCenter[0] - worldExtent[0] , worldCenter[1] - worldExtent[1] , worldCenter[2] - worldExtent[2]},
+        Elite::FPoint3{worldCenter[0] + worldExtent[0] , worldCenter[1] + worldExtent[1] , worldCenter[2] + worldExtent[2]}
+    };
+}
+
+/// @brief grow a box so it holds another one too
+void GrowBounds(BoundingBoxWorld& bounds , const BoundingBoxWorld& other) noexcept
+{
+    bounds.min.x = std::min(bounds.min.x , other.min.x);
+    bounds.min.y = std::min(bounds.min.y , other.min.y);
+    bounds.min.z = std::min(bounds.min.z , other.min.z);
+    bounds.max.x = std::max(bounds.max.x , other.max.x);
+    bounds.max.y = std::max(bounds.max.y , other.max.y);
+    bounds.max.z = std::max(bounds.max.z , other.max.z);
+}
+
+namespace
+{
+    constexpr BoundingBoxWorld EmptyBounds{{FLT_MAX , FLT_MAX , FLT_MAX} , {-FLT_MAX , -FLT_MAX , -FLT_MAX}};
+
+    float GetCenter(const BoundingBoxWorld& bounds , int axis) noexcept
+    {
+        switch(axis)
+        {
+            case 0:
+                return bounds.min.x + bounds.max.x;
+            case 1:
+                return bounds.min.y + bounds.max.y;
+            default:
+                return bounds.min.z + bounds.max.z;
+        }
+    }
+
+    enum class PlaneSide
+    {
+        Outside ,
+        Intersecting ,
+        Inside
+    };
+
+    /// @brief test a box against a plane with its corners farthest along and against the plane normal
+    PlaneSide GetPlaneSide(const software::FrustumPlane& plane , const BoundingBoxWorld& bounds) noexcept
+    {
+        const float farthest = plane.a * (plane.a >= 0.0f ? bounds.max.x : bounds.min.x) + plane.b * (plane.b >= 0.0f ? bounds.max.y : bounds.min.y)
+            + plane.c * (plane.c >= 0.0f ? bounds.max.z : bounds.min.z) + plane.d;
+        if(farthest < 0.0f) return PlaneSide::Outside;
+
+        const float nearest = plane.a * (plane.a >= 0.0f ? bounds.min.x : bounds.max.x) + plane.b * (plane.b >= 0.0f ? bounds.min.y : bounds.max.y)
+            + plane.c * (plane.c >= 0.0f ? bounds.min.z : bounds.max.z) + plane.d;
+        return nearest >= 0.0f ? PlaneSide::Inside : PlaneSide::Intersecting;
+    }
+}
+
+// ---- Functionality ----
+
+/// @brief bring the tree up to date with the primitives of the scene, call once per frame before culling
+/// @brief a different set of primitives rebuilds the tree, moved primitives only refit the bounds of the nodes
+/// @param primitives the primitives of the active scene
+/// @param worldMatrices the world matrix of every primitive, from the snapshot of the frame
+/// @param getObjectBounds gets the object space bounds of the mesh of a primitive, only called when the primitive is new
+void SceneBVH::Update(const std::vector<Primitive*>& primitives , const std::vector<Elite::FMatrix4>& worldMatrices
+    , const std::function<BoundingBoxWorld(const Primitive*)>& getObjectBounds)
+{
+    if(!std::equal(primitives.begin() , primitives.end() , m_Primitives.begin() , m_Primitives.end()))
+    {
+        m_Primitives.assign(primitives.begin() , primitives.end());
+        m_WorldMatrices.resize(primitives.size());
+        m_ObjectBounds.resize(primitives.size());
+        m_WorldBounds.resize(primitives.size());
+
+        for(size_t i = 0; i < primitives.size(); ++i)
+        {
+            m_WorldMatrices[i] = worldMatrices[i];
+            m_ObjectBounds[i] = getObjectBounds(primitives[i]);
+            m_WorldBounds[i] = TransformBounds(m_ObjectBounds[i] , m_WorldMatrices[i]);
+        }
+
+        Build();
+        return;
+    }
+
+    bool hasMoved = false;
+    for(size_t i = 0; i < primitives.size(); ++i)
+    {
+        const Elite::FMatrix4& worldMatrix = worldMatrices[i];
+        if(std::memcmp(&worldMatrix , &m_WorldMatrices[i] , sizeof(Elite::FMatrix4)) == 0) continue;
+
+        m_WorldMatrices[i] = worldMatrix;
+        m_WorldBounds[i] = TransformBounds(m_ObjectBounds[i] , worldMatrix);
+        hasMoved = true;
+    }
+
+    if(hasMoved) Refit();
+}
+
+/// @brief mark the primitives that can be inside the camera frustum
+/// @param viewProjectionMatrix projection * view of the camera, clip space with -w <= x , y <= w and 0 <= z <= w
+/// @param isVisible output, 1 for every primitive with bounds overlapping the frustum, in the order of the primitives
+void SceneBVH::CullFrustum(const Elite::FMatrix4& viewProjectionMatrix , std::vector<uint8_t>& isVisible) const
+{
+    isVisible.assign(m_Primitives.size() , 0);
+    if(m_Nodes.empty()) return;
+
+    software::FrustumPlane planes[6];
+    software::ExtractFrustumPlanes(viewProjectionMatrix , planes);
+    constexpr uint32_t allPlanes = (1 << 6) - 1;
+
+    //node and the planes it still intersects, children of a node inside a plane don't test it again
+    std::pair<uint32_t , uint32_t> stack[64];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = {0 , allPlanes};
+
+    while(stackSize > 0)
+    {
+        const auto [nodeIndex , parentPlanes] = stack[--stackSize];
+        const Node& node = m_Nodes[nodeIndex];
+
+        uint32_t planeMask = parentPlanes;
+        bool isOutside = false;
+        for(uint32_t plane = 0; plane < 6 && !isOutside; ++plane)
+        {
+            if((planeMask & (1 << plane)) == 0) continue;
+
+            const PlaneSide side = GetPlaneSide(planes[plane] , node.bounds);
+            if(side == PlaneSide::Outside) isOutside = true;
+            else if(side == PlaneSide::Inside) planeMask &= ~(1 << plane);
+        }
+        if(isOutside) continue;
+
+        if(node.count > 0)
+        {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) isVisible[m_PrimitiveOrder[i]] = 1;
+            continue;
+        }
+
+        stack[stackSize++] = {node.first , planeMask};
+        stack[stackSize++] = {node.first + 1 , planeMask};
+    }
+}
+
+// ---- Private Functions ----
+
+/// @brief build the tree top down over the world bounds of the primitives
+void SceneBVH::Build()
+{
+    m_Nodes.clear();
+    m_PrimitiveOrder.resize(m_Primitives.size());
+    for(uint32_t i = 0; i < m_PrimitiveOrder.size(); ++i) m_PrimitiveOrder[i] = i;
+
+    if(m_Primitives.empty()) return;
+
+    //a binary tree with leaves of at least 1 primitive has less than 2n nodes
+    m_Nodes.reserve(m_Primitives.size() * 2);
+    m_Nodes.push_back(Node{});
+    BuildNode(0 , 0 , static_cast<uint32_t>(m_Primitives.size()));
+}
+
+/// @brief fill in a node, split it at the median of the longest axis of the centers of its primitives
+/// @param nodeIndex the node to fill in, already in m_Nodes
+/// @param first the first primitive of the node in m_PrimitiveOrder
+/// @param count the amount of primitives of the node
+void SceneBVH::BuildNode(uint32_t nodeIndex , uint32_t first , uint32_t count)
+{
+    BoundingBoxWorld bounds = EmptyBounds;
+    BoundingBoxWorld centerBounds = EmptyBounds;
+    for(uint32_t i = first; i < first + count; ++i)
+    {
+        const BoundingBoxWorld& primitiveBounds = m_WorldBounds[m_PrimitiveOrder[i]];
+        GrowBounds(bounds , primitiveBounds);
+
+        const Elite::FPoint3 center{GetCenter(primitiveBounds , 0) , GetCenter(primitiveBounds , 1) , GetCenter(primitiveBounds , 2)};
+        GrowBounds(centerBounds , BoundingBoxWorld{center , center});
+    }
+    m_Nodes[nodeIndex].bounds = bounds;
+
+    if(count <= MaxLeafSize)
+    {
+        m_Nodes[nodeIndex].first = first;
+        m_Nodes[nodeIndex].count = count;
+        return;
+    }
+
+    const float size[3]{centerBounds.max.x - centerBounds.min.x , centerBounds.max.y - centerBounds.min.y , centerBounds.max.z - centerBounds.min.z};
+    const int axis = (size[0] >= size[1] && size[0] >= size[2]) ? 0 : (size[1] >= size[2] ? 1 : 2);
+
+    const uint32_t half = count / 2;
+    std::nth_element(m_PrimitiveOrder.begin() + first , m_PrimitiveOrder.begin() + first + half , m_PrimitiveOrder.begin() + first + count
+        , [this , axis](uint32_t a , uint32_t b) { return GetCenter(m_WorldBounds[a] , axis) < GetCenter(m_WorldBounds[b] , axis); });
+
+    //both children next to each other
+    const uint32_t childIndex = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.push_back(Node{});
+    m_Nodes.push_back(Node{});
+    m_Nodes[nodeIndex].first = childIndex;
+    m_Nodes[nodeIndex].count = 0;
+
+    BuildNode(childIndex , first , half);
+    BuildNode(childIndex + 1 , first + half , count - half);
+}
+
+/// @brief recalculate the bounds of every node bottom up, the tree keeps its shape
+void SceneBVH::Refit()
+{
+    //children are always stored after their parent
+    for(size_t nodeIndex = m_Nodes.size(); nodeIndex-- > 0;)
+    {
+        Node& node = m_Nodes[nodeIndex];
+        node.bounds = EmptyBounds;
+
+        if(node.count > 0)
+        {
+            for(uint32_t i = node.first; i < node.first + node.count; ++i) GrowBounds(node.bounds , m_WorldBounds[m_PrimitiveOrder[i]]);
+            continue;
+        }
+
+        GrowBounds(node.bounds , m_Nodes[node.first].bounds);
+        GrowBounds(node.bounds , m_Nodes[node.first + 1].bounds);
+    }
+}
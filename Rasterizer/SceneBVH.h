@@ -0,0 +1,91 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+
+// - Forward Declaration -
+class Primitive;
+
+/// @brief axis aligned box, in object space for a mesh or in world space for a placed primitive
+struct BoundingBoxWorld
+{
+    Elite::FPoint3 min;
+    Elite::FPoint3 max;
+};
+
+BoundingBoxWorld TransformBounds(const BoundingBoxWorld& bounds , const Elite::FMatrix4& worldMatrix);
+void GrowBounds(BoundingBoxWorld& bounds , const BoundingBoxWorld& other) noexcept;
+
+/// @brief A bounding volume hierarchy over the world bounds of the primitives of a scene
+/// @brief Used to skip whole primitives outside the camera frustum before their vertices get transformed
+/// @brief It is rebuilt when the primitives of the scene change and refit when only world matrices change
+class SceneBVH final
+{
+public:
+
+      // ---- Constructors ----
+    SceneBVH() = default;
+
+    // ---- Destructor ----
+    ~SceneBVH() = default;
+
+    // ---- Copy/Move ----
+    SceneBVH(const SceneBVH& other) = delete; //copy constructor
+    SceneBVH(SceneBVH&& other) noexcept = delete; //move constructor
+    SceneBVH& operator=(const SceneBVH& other) = delete; // copy assignment
+    SceneBVH& operator=(SceneBVH&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    void Update(const std::vector<Primitive*>& primitives , const std::vector<Elite::FMatrix4>& worldMatrices
+        , const std::function<BoundingBoxWorld(const Primitive*)>& getObjectBounds);
+    void CullFrustum(const Elite::FMatrix4& viewProjectionMatrix , std::vector<uint8_t>& isVisible) const;
+
+    // -- Getters --
+    size_t GetNodeCount() const noexcept;
+    const BoundingBoxWorld& GetWorldBounds(size_t primitiveIndex) const noexcept;
+
+private:
+
+      // ---- Private Functions ----
+    void Build();
+    void BuildNode(uint32_t nodeIndex , uint32_t first , uint32_t count);
+    void Refit();
+
+    // ---- Data members ----
+    /// @brief a leaf when count > 0, then first indexes m_PrimitiveOrder, else the children are first and first + 1
+    struct Node
+    {
+        BoundingBoxWorld bounds;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    static constexpr uint32_t MaxLeafSize{4};
+
+    std::vector<Node> m_Nodes; //root first, children always after their parent
+    std::vector<uint32_t> m_PrimitiveOrder; //primitive indices, grouped per leaf
+    std::vector<const Primitive*> m_Primitives; //the primitives the tree was built for
+    std::vector<Elite::FMatrix4> m_WorldMatrices; //the world matrices of the last update, to detect moved primitives
+    std::vector<BoundingBoxWorld> m_ObjectBounds;
+    std::vector<BoundingBoxWorld> m_WorldBounds;
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// -- Getters --
+inline size_t SceneBVH::GetNodeCount() const noexcept
+{
+    return m_Nodes.size();
+}
+
+inline const BoundingBoxWorld& SceneBVH::GetWorldBounds(size_t primitiveIndex) const noexcept
+{
+    return m_WorldBounds[primitiveIndex];
+}
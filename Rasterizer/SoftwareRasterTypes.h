@@ -0,0 +1,229 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+#include <immintrin.h>
+
+// - Project includes -
+#include "EMath.h"
+#include "EdgeFunctions.h"
+#include "PipelineStats.h"
+
+// - Forward Declaration -
+class Primitive;
+
+namespace software
+{
+    /// @brief the width and height in pixels of one screen tile of the tiled software rasterizer
+    constexpr uint32_t TileSize{64};
+
+    /// @brief the width and height in pixels of the blocks a triangle gets classified in before per pixel work
+    constexpr int BlockSize{8};
+
+    /// @brief inclusive pixel rectangle, used for screen tiles and for the pixels a triangle can touch
+    struct PixelRect
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    /// @brief the attributes that get interpolated over a triangle, index in ClipVertex::attributes
+    enum VertexAttribute
+    {
+        AttributeU ,
+        AttributeV ,
+        AttributeNormalX ,
+        AttributeNormalY ,
+        AttributeNormalZ ,
+        AttributeTangentX ,
+        AttributeTangentY ,
+        AttributeTangentZ ,
+        AttributeViewDirectionX ,
+        AttributeViewDirectionY ,
+        AttributeViewDirectionZ ,
+        VertexAttributeCount
+    };
+
+    /// @brief a vertex of the geometry stage, clipping creates new ones by interpolating all members
+    struct ClipVertex
+    {
+        Elite::FPoint4 position; //homogeneous clip space, raster space after triangle setup
+        float attributes[VertexAttributeCount];
+    };
+
+    /// @brief one plane per interpolated value, the attributes divided by w and then 1 / w, a multiple of 4 for the simd loads
+    constexpr int AttributePlaneCount{VertexAttributeCount + 1};
+    constexpr int PlaneInvW{VertexAttributeCount};
+    static_assert(AttributePlaneCount % 4 == 0 , "the planes get loaded 4 at a time");
+
+    /// @brief the interpolated values of a triangle as plane equations over raster space, set up once per triangle
+    /// @brief value(x, y) = gradientX * x + gradientY * y + origin at the center of pixel (x, y)
+    /// @brief the next pixel of a span or a 2x2 quad is one add of a gradient away
+    /// @brief the attributes are divided by w, a pixel gets them perspective correct with one reciprocal of the 1 / w plane
+    struct AttributePlanes
+    {
+        alignas(16) float gradientX[AttributePlaneCount];
+        alignas(16) float gradientY[AttributePlaneCount];
+        alignas(16) float origin[AttributePlaneCount];
+    };
+
+    /// @brief the render state of a primitive the raster kernels are specialized on, the same for all of its triangles
+    enum RasterStateFlags : uint8_t
+    {
+        RasterStateWriteDepth = 1 << 0 ,
+        RasterStateBlend = 1 << 1 ,
+        RasterStateCount = 1 << 2 , //every combination of the flags above
+        RasterStateRuntime = RasterStateCount //not a state, the kernel reads the flags of the triangle instead, to compare against
+    };
+
+    /// @brief a triangle that survived culling in the geometry stage, it gets binned into every tile its bounding box overlaps
+    /// @brief it holds its own attribute planes, so triangles created by clipping need no extra storage
+    struct RasterTriangle
+    {
+        Primitive* pPrimitive;
+        uint8_t rasterState; //RasterStateFlags of the primitive, picks the raster kernel
+        float areaParallelogram;
+        float nearestDepth; //smallest vertex depth, no pixel of the triangle is closer
+        TriangleEdges edges;
+        PixelRect pixelBounds;
+        AttributePlanes planes;
+    };
+
+    /// @brief counters of the software raster stage, reset every frame
+    struct RasterStats
+    {
+        uint64_t blocksRejected; //fully outside the triangle, skipped
+        uint64_t blocksAccepted; //fully inside the triangle, no per pixel edge tests
+        uint64_t blocksPartial; //crossing an edge, tested per pixel
+        uint64_t blocksOccluded; //behind the farthest depth of the block in the hierarchical z buffer
+        uint64_t trianglesOccluded; //behind the farthest depth of the whole tile
+        uint64_t pixelsShaded; //calls to the pixel shader, more than the screen has pixels when there is overdraw
+        uint64_t pixelsCoarseShaded; //got the color of a pixel of the same triangle shaded for its coarse block, no pixel shader call
+        PipelineStats pipeline; //only counted with SOFTWARE_PIPELINE_STATS
+    };
+
+    /// @brief how the software renderer shades the pixels
+    enum class ShadingMode
+    {
+        Forward , //shade every fragment that passes the depth test
+        Deferred //write a visibility buffer first, then shade every visible pixel once, blended primitives forward on top
+    };
+
+    /// @brief how many pixels the deferred shading shades at once, picked per 8x8 block from the contrast of the last frame
+    /// @brief a coarse block is shaded once per triangle covering it, the depth and the visibility stay per pixel
+    enum class ShadingRate : uint8_t
+    {
+        Full , //every pixel
+        Coarse2x2 ,
+        Coarse4x4
+    };
+
+    /// @brief the largest luminance difference between pixels 4 apart in a block that still gets shaded at a rate
+    constexpr float Coarse4x4MaxContrast{1.0f / 64.0f};
+    constexpr float Coarse2x2MaxContrast{1.0f / 16.0f};
+
+    /// @brief the passes over the triangles of a tile
+    enum class RasterPass
+    {
+        Forward , //every triangle, shaded
+        Visibility , //opaque triangles, written to the visibility buffer
+        Blended //blended triangles, shaded on top of the resolved visibility buffer
+    };
+
+    /// @brief the visible triangle of a pixel in the deferred mode, the triangle also gives the primitive
+    struct VisibilitySample
+    {
+        uint32_t triangleIndex; //index in the set up triangles of the frame, InvalidTriangleIndex when not covered
+        float weight0;
+        float weight1;
+        float weight2;
+    };
+
+    constexpr uint32_t InvalidTriangleIndex{0xFFFFFFFF};
+
+    /// @brief check a flag of the state a raster kernel is specialized on, a constant unless it is the runtime kernel
+    /// @param triangleState the RasterStateFlags of the triangle, only read by the runtime kernel
+    /// @param flag the flag to check
+    template<uint8_t KernelState>
+    constexpr bool GetHasRasterState(uint8_t triangleState , uint8_t flag) noexcept
+    {
+        if constexpr(KernelState == RasterStateRuntime) return (triangleState & flag) != 0;
+        else return (KernelState & flag) != 0;
+    }
+
+    /// @brief set up the plane equations of the attributes divided by w and of 1 / w, once per triangle
+    /// @param edges the edge equations of the triangle, they give the barycentric weights at the pixel centers
+    /// @param vertex0 first vertex, position in raster space with the clip space w
+    /// @param vertex1 second vertex
+    /// @param vertex2 third vertex
+    /// @param planes output
+    inline void SetupAttributePlanes(const TriangleEdges& edges , const ClipVertex& vertex0 , const ClipVertex& vertex1
+        , const ClipVertex& vertex2 , AttributePlanes& planes) noexcept
+    {
+        //the planes are the weighted sums of the edge equations, the weights are linear in raster space
+        const auto setupPlane = [&edges , &planes](int plane , float value0 , float value1 , float value2)
+        {
+            planes.gradientX[plane] = value0 * edges.edge0[0] + value1 * edges.edge1[0] + value2 * edges.edge2[0];
+            planes.gradientY[plane] = value0 * edges.edge0[1] + value1 * edges.edge1[1] + value2 * edges.edge2[1];
+            planes.origin[plane] = value0 * edges.edge0[2] + value1 * edges.edge1[2] + value2 * edges.edge2[2];
+        };
+
+        const float invW0 = 1.0f / vertex0.position.w;
+        const float invW1 = 1.0f / vertex1.position.w;
+        const float invW2 = 1.0f / vertex2.position.w;
+        for(int i = 0; i < VertexAttributeCount; ++i)
+        {
+            setupPlane(i , vertex0.attributes[i] * invW0 , vertex1.attributes[i] * invW1 , vertex2.attributes[i] * invW2);
+        }
+        setupPlane(PlaneInvW , invW0 , invW1 , invW2);
+    }
+
+    /// @brief perspective correct interpolation of uv, normal, tangent and view direction from the attribute planes
+    /// @brief 4 planes per instruction and a single reciprocal for all attributes
+    /// @param vertexOUT output vertex
+    /// @param triangle the triangle with the attribute planes
+    /// @param x column of the pixel
+    /// @param y row of the pixel
+    /// @return the interpolated w value
+    template<typename VertexOutput>
+    float InterpolateAttributes(VertexOutput& vertexOUT , const RasterTriangle& triangle , uint32_t x , uint32_t y)
+    {
+        const AttributePlanes& planes = triangle.planes;
+        const __m128 column = _mm_set1_ps(static_cast<float>(x));
+        const __m128 row = _mm_set1_ps(static_cast<float>(y));
+
+        alignas(16) float values[AttributePlaneCount];
+        for(int i = 0; i < AttributePlaneCount; i += 4)
+        {
+            _mm_store_ps(values + i , _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(planes.gradientX + i) , column)
+                , _mm_mul_ps(_mm_load_ps(planes.gradientY + i) , row)) , _mm_load_ps(planes.origin + i)));
+        }
+
+        const float wInterpolated = 1.0f / values[PlaneInvW];
+        const __m128 w = _mm_set1_ps(wInterpolated);
+        for(int i = 0; i < AttributePlaneCount; i += 4) _mm_store_ps(values + i , _mm_mul_ps(_mm_load_ps(values + i) , w));
+
+        vertexOUT.uv = Elite::FVector2{values[AttributeU] , values[AttributeV]};
+        vertexOUT.normal = Elite::GetNormalized(Elite::FVector3{values[AttributeNormalX] , values[AttributeNormalY]
+            , values[AttributeNormalZ]});
+        vertexOUT.tangent = Elite::GetNormalized(Elite::FVector3{values[AttributeTangentX] , values[AttributeTangentY]
+            , values[AttributeTangentZ]});
+        vertexOUT.viewDirection = Elite::GetNormalized(Elite::FVector3{values[AttributeViewDirectionX]
+            , values[AttributeViewDirectionY] , values[AttributeViewDirectionZ]});
+        return wInterpolated;
+    }
+
+    /// @brief get the overlapping part of two pixel rectangles, right < left or bottom < top when they don't overlap
+    inline PixelRect GetIntersection(const PixelRect& a , const PixelRect& b) noexcept
+    {
+        return PixelRect
+        {
+            a.left > b.left ? a.left : b.left,
+            a.top > b.top ? a.top : b.top,
+            a.right < b.right ? a.right : b.right,
+            a.bottom < b.bottom ? a.bottom : b.bottom
+        };
+    }
+}
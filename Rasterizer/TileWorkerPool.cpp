@@ -0,0 +1,110 @@
+#include "TileWorkerPool.h"
+
+// ---- Constructors ----
+
+/// @brief creates the pool and starts the worker threads
+/// @param threadCount the total amount of threads working on a batch, including the calling thread
+TileWorkerPool::TileWorkerPool(uint32_t threadCount)
+    : m_pTask{nullptr}
+    , m_InvokeTask{nullptr}
+    , m_NextTask{0}
+    , m_TaskCount{0}
+    , m_Generation{0}
+    , m_BusyWorkers{0}
+    , m_IsShuttingDown{false}
+{
+    if(threadCount == 0) threadCount = 1;
+
+    m_Workers.reserve(threadCount - 1);
+    for(uint32_t i = 1; i < threadCount; ++i)
+    {
+        m_Workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+// ---- Destructor ----
+
+TileWorkerPool::~TileWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_Mutex};
+        m_IsShuttingDown = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for(std::thread& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+// ---- Private Functions ----
+
+/// @brief the untyped part of Run, execute a batch and block until all its tasks are done
+/// @param taskCount the amount of tasks in this batch
+/// @param pTask the callable of the batch
+/// @param invokeTask calls pTask with the index of a task
+void TileWorkerPool::RunBatch(uint32_t taskCount , const void* pTask , InvokeTaskFunction invokeTask)
+{
+    if(taskCount == 0) return;
+
+    //no workers, no need to synchronize
+    if(m_Workers.empty())
+    {
+        for(uint32_t i = 0; i < taskCount; ++i) invokeTask(pTask , i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_Mutex};
+        m_pTask = pTask;
+        m_InvokeTask = invokeTask;
+        m_TaskCount = taskCount;
+        m_NextTask.store(0 , std::memory_order_relaxed);
+        m_BusyWorkers = static_cast<uint32_t>(m_Workers.size());
+        ++m_Generation;
+    }
+    m_WakeCondition.notify_all();
+
+    //the calling thread helps out
+    ExecuteTasks();
+
+    //wait for the workers to finish their last task
+    std::unique_lock<std::mutex> lock{m_Mutex};
+    m_DoneCondition.wait(lock , [this] { return m_BusyWorkers == 0; });
+    m_pTask = nullptr;
+    m_InvokeTask = nullptr;
+}
+
+/// @brief sleeps until a new batch is started, then helps executing it
+void TileWorkerPool::WorkerLoop()
+{
+    uint32_t lastGeneration = 0;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_Mutex};
+            m_WakeCondition.wait(lock , [this , lastGeneration] { return m_IsShuttingDown || m_Generation != lastGeneration; });
+            if(m_IsShuttingDown) return;
+            lastGeneration = m_Generation;
+        }
+
+        ExecuteTasks();
+
+        {
+            std::lock_guard<std::mutex> lock{m_Mutex};
+            --m_BusyWorkers;
+        }
+        m_DoneCondition.notify_one();
+    }
+}
+
+/// @brief grab task indices until the batch is empty
+void TileWorkerPool::ExecuteTasks()
+{
+    for(uint32_t task = m_NextTask.fetch_add(1); task < m_TaskCount; task = m_NextTask.fetch_add(1))
+    {
+        m_InvokeTask(m_pTask , task);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// - Standard includes -
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// @brief A small persistent pool of threads that executes a batch of indexed tasks (the screen tiles of the software rasterizer)
+/// @brief The calling thread takes part in the work, so a pool with a thread count of 1 runs everything inline
+/// @brief A batch calls its task through a pointer, no type erased wrapper gets built, so starting one never allocates
+class TileWorkerPool final
+{
+public:
+
+      // ---- Constructors ----
+    explicit TileWorkerPool(uint32_t threadCount);
+
+    // ---- Destructor ----
+    ~TileWorkerPool();
+
+    // ---- Copy/Move ----
+    TileWorkerPool(const TileWorkerPool& other) = delete; //copy constructor
+    TileWorkerPool(TileWorkerPool&& other) noexcept = delete; //move constructor
+    TileWorkerPool& operator=(const TileWorkerPool& other) = delete; // copy assignment
+    TileWorkerPool& operator=(TileWorkerPool&& other) noexcept = delete; //move assignment
+
+    // ---- Functionality ----
+    template<typename Task>
+    void Run(uint32_t taskCount , Task&& task);
+
+    // -- Getters --
+    uint32_t GetThreadCount() const noexcept;
+
+private:
+
+    using InvokeTaskFunction = void (*)(const void* pTask , uint32_t taskIndex);
+
+      // ---- Private Functions ----
+    void RunBatch(uint32_t taskCount , const void* pTask , InvokeTaskFunction invokeTask);
+    void WorkerLoop();
+    void ExecuteTasks();
+
+    // ---- Data members ----
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_DoneCondition;
+    const void* m_pTask; //the callable of the running batch, owned by the caller of Run
+    InvokeTaskFunction m_InvokeTask;
+    std::atomic<uint32_t> m_NextTask;
+    uint32_t m_TaskCount;
+    uint32_t m_Generation;
+    uint32_t m_BusyWorkers;
+    bool m_IsShuttingDown;
+};
+
+// =============================================================================
+//                               Inline Definitions
+// =============================================================================
+
+// ---- Functionality ----
+
+/// @brief execute the task for every index in [0, taskCount), blocks until all tasks are done
+/// @param taskCount the amount of tasks in this batch
+/// @param task callable with the index of the task, only referenced for the duration of the batch
+template<typename Task>
+void TileWorkerPool::Run(uint32_t taskCount , Task&& task)
+{
+    using TaskType = std::remove_reference_t<Task>;
+    RunBatch(taskCount , std::addressof(task) , [](const void* pTask , uint32_t taskIndex)
+    {
+        (*const_cast<TaskType*>(static_cast<const TaskType*>(pTask)))(taskIndex);
+    });
+}
+
+// -- Getters --
+inline uint32_t TileWorkerPool::GetThreadCount() const noexcept
+{
+    //the calling thread counts as a worker
+    return static_cast<uint32_t>(m_Workers.size()) + 1;
+}
@@ -0,0 +1,117 @@
+#include "TriangleClipper.h"
+
+namespace
+{
+    /// @brief signed distance to a clip plane in homogeneous space, inside when >= 0
+    float GetPlaneDistance(const Elite::FPoint4& position , uint32_t plane) noexcept
+    {
+        using namespace software;
+
+        const float guardBand = GuardBandScale * position.w;
+        switch(plane)
+        {
+            case ClipNear:
+                return position.z;
+            case ClipFar:
+                return position.w - position.z;
+            case ClipGuardLeft:
+                return position.x + guardBand;
+            case ClipGuardRight:
+                return guardBand - position.x;
+            case ClipGuardBottom:
+                return position.y + guardBand;
+            case ClipGuardTop:
+                return guardBand - position.y;
+            default:
+                return 1.0f;
+        }
+    }
+
+    /// @brief linear interpolation of the position and all the attributes, clip space is linear so this is exact
+    software::ClipVertex LerpClipVertex(const software::ClipVertex& a , const software::ClipVertex& b , float t) noexcept
+    {
+        software::ClipVertex result;
+        result.position.x = a.position.x + (b.position.x - a.position.x) * t;
+        result.position.y = a.position.y + (b.position.y - a.position.y) * t;
+        result.position.z = a.position.z + (b.position.z - a.position.z) * t;
+        result.position.w = a.position.w + (b.position.w - a.position.w) * t;
+        for(int i = 0; i < software::VertexAttributeCount; ++i)
+        {
+            result.attributes[i] = a.attributes[i] + (b.attributes[i] - a.attributes[i]) * t;
+        }
+        return result;
+    }
+}
+
+namespace software
+{
+    /// @brief get the planes a clip space position is outside of
+    /// @param position homogeneous clip space position
+    /// @return ClipPlane bits
+    uint32_t GetOutcode(const Elite::FPoint4& position) noexcept
+    {
+        const float guardBand = GuardBandScale * position.w;
+
+        uint32_t outcode = 0;
+        if(position.z < 0.0f) outcode |= ClipNear;
+        if(position.z > position.w) outcode |= ClipFar;
+        if(position.x < -position.w) outcode |= ClipLeft;
+        if(position.x > position.w) outcode |= ClipRight;
+        if(position.y < -position.w) outcode |= ClipBottom;
+        if(position.y > position.w) outcode |= ClipTop;
+        if(position.x < -guardBand) outcode |= ClipGuardLeft;
+        if(position.x > guardBand) outcode |= ClipGuardRight;
+        if(position.y < -guardBand) outcode |= ClipGuardBottom;
+        if(position.y > guardBand) outcode |= ClipGuardTop;
+        return outcode;
+    }
+
+    /// @brief clip a triangle against planes in homogeneous space (Sutherland-Hodgman), keeps the winding order
+    /// @param triangle the three clip space vertices
+    /// @param planes ClipPlane bits of the planes to clip against
+    /// @param polygon output, a convex polygon that can be fanned around its first vertex
+    /// @return the amount of vertices of the polygon, less than 3 when nothing is left
+    uint32_t ClipTriangle(const ClipVertex (&triangle)[3] , uint32_t planes , ClipVertex (&polygon)[MaxClippedVertices]) noexcept
+    {
+        ClipVertex buffer[MaxClippedVertices];
+        ClipVertex* pInput = polygon;
+        ClipVertex* pOutput = buffer;
+
+        uint32_t vertexCount = 3;
+        for(uint32_t i = 0; i < 3; ++i) pInput[i] = triangle[i];
+
+        for(uint32_t plane = 1; plane <= planes && vertexCount >= 3; plane <<= 1)
+        {
+            if((planes & plane) == 0) continue;
+
+            uint32_t outputCount = 0;
+            for(uint32_t i = 0; i < vertexCount; ++i)
+            {
+                const ClipVertex& current = pInput[i];
+                const ClipVertex& next = pInput[(i + 1) % vertexCount];
+                const float currentDistance = GetPlaneDistance(current.position , plane);
+                const float nextDistance = GetPlaneDistance(next.position , plane);
+
+                if(currentDistance >= 0.0f) pOutput[outputCount++] = current;
+
+                //the edge crosses the plane
+                if((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                {
+                    pOutput[outputCount++] = LerpClipVertex(current , next , currentDistance / (currentDistance - nextDistance));
+                }
+            }
+
+            vertexCount = outputCount;
+            ClipVertex* const pSwap = pInput;
+            pInput = pOutput;
+            pOutput = pSwap;
+        }
+
+        //the result has to end up in the output array
+        if(pInput != polygon)
+        {
+            for(uint32_t i = 0; i < vertexCount; ++i) polygon[i] = pInput[i];
+        }
+        return vertexCount;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// - Standard includes -
+#include <cstdint>
+
+// - Project includes -
+#include "SoftwareRasterTypes.h"
+
+namespace software
+{
+    /// @brief size of the guard band in ndc units, triangles inside it are rasterized with a clamped bounding box instead of clipped
+    constexpr float GuardBandScale{4.0f};
+
+    /// @brief the planes a clip space vertex can be outside of, the side planes exist twice: frustum and guard band
+    enum ClipPlane : uint32_t
+    {
+        ClipNear = 1 << 0 , //z < 0
+        ClipFar = 1 << 1 , //z > w
+        ClipLeft = 1 << 2 , //x < -w
+        ClipRight = 1 << 3 , //x > w
+        ClipBottom = 1 << 4 , //y < -w
+        ClipTop = 1 << 5 , //y > w
+        ClipGuardLeft = 1 << 6 , //x < -GuardBandScale * w
+        ClipGuardRight = 1 << 7 ,
+        ClipGuardBottom = 1 << 8 ,
+        ClipGuardTop = 1 << 9 ,
+
+        //planes that are really clipped against, the frustum sides are handled by the guard band
+        ClipPlanesToClip = ClipNear | ClipFar | ClipGuardLeft | ClipGuardRight | ClipGuardBottom | ClipGuardTop
+    };
+
+    /// @brief the most vertices a clipped triangle can have, every clipped plane adds at most one
+    constexpr uint32_t MaxClippedVertices{3 + 6};
+
+    uint32_t GetOutcode(const Elite::FPoint4& position) noexcept;
+    uint32_t ClipTriangle(const ClipVertex (&triangle)[3] , uint32_t planes , ClipVertex (&polygon)[MaxClippedVertices]) noexcept;
+}
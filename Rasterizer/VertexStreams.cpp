@@ -0,0 +1,283 @@
+#include "VertexStreams.h"
+
+// - Standard includes -
+#include <cmath>
+#include <immintrin.h>
+
+//msvc compiles intrinsics of any instruction set, gcc and clang need the target on the function
+#if defined(_MSC_VER)
+#define SOFTWARE_TARGET_AVX2
+#else
+#define SOFTWARE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+    /// @brief the matrices of the vertex stage as plain row major floats, element [r * 4 + c]
+    struct VertexStageMatrices
+    {
+        float world[16];
+        float worldViewProjection[16];
+        float cameraPosition[3];
+    };
+
+    /// @brief one vertex at a time, fallback when the cpu has no usable simd
+    void TransformScalar(const software::ObjectVertexStreams& in , software::TransformedVertexStreams& out
+        , const VertexStageMatrices& matrices , size_t first , size_t last)
+    {
+        const float* m = matrices.worldViewProjection;
+        const float* w = matrices.world;
+
+        for(size_t i = first; i < last; ++i)
+        {
+            const float px = in.positionX[i] , py = in.positionY[i] , pz = in.positionZ[i];
+
+            //world view projection, the perspective divide happens after clipping
+            out.positionX[i] = m[0] * px + m[1] * py + m[2] * pz + m[3];
+            out.positionY[i] = m[4] * px + m[5] * py + m[6] * pz + m[7];
+            out.positionZ[i] = m[8] * px + m[9] * py + m[10] * pz + m[11];
+            out.positionW[i] = m[12] * px + m[13] * py + m[14] * pz + m[15];
+
+            //normal and tangent to world space
+            const float nx = w[0] * in.normalX[i] + w[1] * in.normalY[i] + w[2] * in.normalZ[i];
+            const float ny = w[4] * in.normalX[i] + w[5] * in.normalY[i] + w[6] * in.normalZ[i];
+            const float nz = w[8] * in.normalX[i] + w[9] * in.normalY[i] + w[10] * in.normalZ[i];
+            const float invNormalLength = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+            out.normalX[i] = nx * invNormalLength;
+            out.normalY[i] = ny * invNormalLength;
+            out.normalZ[i] = nz * invNormalLength;
+
+            const float tx = w[0] * in.tangentX[i] + w[1] * in.tangentY[i] + w[2] * in.tangentZ[i];
+            const float ty = w[4] * in.tangentX[i] + w[5] * in.tangentY[i] + w[6] * in.tangentZ[i];
+            const float tz = w[8] * in.tangentX[i] + w[9] * in.tangentY[i] + w[10] * in.tangentZ[i];
+            const float invTangentLength = 1.0f / std::sqrt(tx * tx + ty * ty + tz * tz);
+            out.tangentX[i] = tx * invTangentLength;
+            out.tangentY[i] = ty * invTangentLength;
+            out.tangentZ[i] = tz * invTangentLength;
+
+            //view direction from the camera to the world position
+            const float vx = w[0] * px + w[1] * py + w[2] * pz + w[3] - matrices.cameraPosition[0];
+            const float vy = w[4] * px + w[5] * py + w[6] * pz + w[7] - matrices.cameraPosition[1];
+            const float vz = w[8] * px + w[9] * py + w[10] * pz + w[11] - matrices.cameraPosition[2];
+            const float invViewLength = 1.0f / std::sqrt(vx * vx + vy * vy + vz * vz);
+            out.viewDirectionX[i] = vx * invViewLength;
+            out.viewDirectionY[i] = vy * invViewLength;
+            out.viewDirectionZ[i] = vz * invViewLength;
+        }
+    }
+
+    /// @brief 4 vertices per instruction
+    void TransformSSE(const software::ObjectVertexStreams& in , software::TransformedVertexStreams& out
+        , const VertexStageMatrices& matrices , size_t first , size_t last)
+    {
+        __m128 m[16] , w[16];
+        for(int i = 0; i < 16; ++i)
+        {
+            m[i] = _mm_set1_ps(matrices.worldViewProjection[i]);
+            w[i] = _mm_set1_ps(matrices.world[i]);
+        }
+        const __m128 cameraX = _mm_set1_ps(matrices.cameraPosition[0]);
+        const __m128 cameraY = _mm_set1_ps(matrices.cameraPosition[1]);
+        const __m128 cameraZ = _mm_set1_ps(matrices.cameraPosition[2]);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        //row r of a 4x4 matrix times (x, y, z, translation)
+        const auto transformRow = [](const __m128* matrix , int row , __m128 x , __m128 y , __m128 z , bool isPoint)
+        {
+            __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix[row * 4] , x) , _mm_mul_ps(matrix[row * 4 + 1] , y))
+                , _mm_mul_ps(matrix[row * 4 + 2] , z));
+            return isPoint ? _mm_add_ps(result , matrix[row * 4 + 3]) : result;
+        };
+
+        const auto normalize = [one](__m128& x , __m128& y , __m128& z)
+        {
+            const __m128 invLength = _mm_div_ps(one , _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x , x) , _mm_mul_ps(y , y))
+                , _mm_mul_ps(z , z))));
+            x = _mm_mul_ps(x , invLength);
+            y = _mm_mul_ps(y , invLength);
+            z = _mm_mul_ps(z , invLength);
+        };
+
+        for(size_t i = first; i < last; i += 4)
+        {
+            const __m128 px = _mm_loadu_ps(&in.positionX[i]) , py = _mm_loadu_ps(&in.positionY[i]) , pz = _mm_loadu_ps(&in.positionZ[i]);
+
+            //world view projection, the perspective divide happens after clipping
+            _mm_storeu_ps(&out.positionX[i] , transformRow(m , 0 , px , py , pz , true));
+            _mm_storeu_ps(&out.positionY[i] , transformRow(m , 1 , px , py , pz , true));
+            _mm_storeu_ps(&out.positionZ[i] , transformRow(m , 2 , px , py , pz , true));
+            _mm_storeu_ps(&out.positionW[i] , transformRow(m , 3 , px , py , pz , true));
+
+            //normal and tangent to world space
+            const __m128 nxIn = _mm_loadu_ps(&in.normalX[i]) , nyIn = _mm_loadu_ps(&in.normalY[i]) , nzIn = _mm_loadu_ps(&in.normalZ[i]);
+            __m128 nx = transformRow(w , 0 , nxIn , nyIn , nzIn , false);
+            __m128 ny = transformRow(w , 1 , nxIn , nyIn , nzIn , false);
+            __m128 nz = transformRow(w , 2 , nxIn , nyIn , nzIn , false);
+            normalize(nx , ny , nz);
+            _mm_storeu_ps(&out.normalX[i] , nx);
+            _mm_storeu_ps(&out.normalY[i] , ny);
+            _mm_storeu_ps(&out.normalZ[i] , nz);
+
+            const __m128 txIn = _mm_loadu_ps(&in.tangentX[i]) , tyIn = _mm_loadu_ps(&in.tangentY[i]) , tzIn = _mm_loadu_ps(&in.tangentZ[i]);
+            __m128 tx = transformRow(w , 0 , txIn , tyIn , tzIn , false);
+            __m128 ty = transformRow(w , 1 , txIn , tyIn , tzIn , false);
+            __m128 tz = transformRow(w , 2 , txIn , tyIn , tzIn , false);
+            normalize(tx , ty , tz);
+            _mm_storeu_ps(&out.tangentX[i] , tx);
+            _mm_storeu_ps(&out.tangentY[i] , ty);
+            _mm_storeu_ps(&out.tangentZ[i] , tz);
+
+            //view direction from the camera to the world position
+            __m128 vx = _mm_sub_ps(transformRow(w , 0 , px , py , pz , true) , cameraX);
+            __m128 vy = _mm_sub_ps(transformRow(w , 1 , px , py , pz , true) , cameraY);
+            __m128 vz = _mm_sub_ps(transformRow(w , 2 , px , py , pz , true) , cameraZ);
+            normalize(vx , vy , vz);
+            _mm_storeu_ps(&out.viewDirectionX[i] , vx);
+            _mm_storeu_ps(&out.viewDirectionY[i] , vy);
+            _mm_storeu_ps(&out.viewDirectionZ[i] , vz);
+        }
+    }
+
+    /// @brief 8 vertices per instruction
+    SOFTWARE_TARGET_AVX2 void TransformAVX2(const software::ObjectVertexStreams& in , software::TransformedVertexStreams& out
+        , const VertexStageMatrices& matrices , size_t first , size_t last)
+    {
+        __m256 m[16] , w[16];
+        for(int i = 0; i < 16; ++i)
+        {
+            m[i] = _mm256_set1_ps(matrices.worldViewProjection[i]);
+            w[i] = _mm256_set1_ps(matrices.world[i]);
+        }
+        const __m256 camera[3]{_mm256_set1_ps(matrices.cameraPosition[0]) , _mm256_set1_ps(matrices.cameraPosition[1])
+            , _mm256_set1_ps(matrices.cameraPosition[2])};
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        for(size_t i = first; i < last; i += 8)
+        {
+            const __m256 px = _mm256_loadu_ps(&in.positionX[i]) , py = _mm256_loadu_ps(&in.positionY[i]) , pz = _mm256_loadu_ps(&in.positionZ[i]);
+
+            //world view projection, the perspective divide happens after clipping
+            __m256 clip[4];
+            for(int row = 0; row < 4; ++row)
+            {
+                clip[row] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[row * 4] , px) , _mm256_mul_ps(m[row * 4 + 1] , py))
+                    , _mm256_add_ps(_mm256_mul_ps(m[row * 4 + 2] , pz) , m[row * 4 + 3]));
+            }
+            _mm256_storeu_ps(&out.positionX[i] , clip[0]);
+            _mm256_storeu_ps(&out.positionY[i] , clip[1]);
+            _mm256_storeu_ps(&out.positionZ[i] , clip[2]);
+            _mm256_storeu_ps(&out.positionW[i] , clip[3]);
+
+            //normal, tangent and view direction to world space, written normalized
+            const float* const inputs[3][3]
+            {
+                {&in.normalX[i] , &in.normalY[i] , &in.normalZ[i]},
+                {&in.tangentX[i] , &in.tangentY[i] , &in.tangentZ[i]},
+                {&in.positionX[i] , &in.positionY[i] , &in.positionZ[i]}
+            };
+            float* const outputs[3][3]
+            {
+                {&out.normalX[i] , &out.normalY[i] , &out.normalZ[i]},
+                {&out.tangentX[i] , &out.tangentY[i] , &out.tangentZ[i]},
+                {&out.viewDirectionX[i] , &out.viewDirectionY[i] , &out.viewDirectionZ[i]}
+            };
+
+            for(int stream = 0; stream < 3; ++stream)
+            {
+                const bool isPoint = stream == 2;
+                const __m256 x = _mm256_loadu_ps(inputs[stream][0]) , y = _mm256_loadu_ps(inputs[stream][1]) , z = _mm256_loadu_ps(inputs[stream][2]);
+
+                __m256 world[3];
+                for(int row = 0; row < 3; ++row)
+                {
+                    world[row] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w[row * 4] , x) , _mm256_mul_ps(w[row * 4 + 1] , y))
+                        , _mm256_mul_ps(w[row * 4 + 2] , z));
+                    if(isPoint) world[row] = _mm256_sub_ps(_mm256_add_ps(world[row] , w[row * 4 + 3]) , camera[row]);
+                }
+
+                const __m256 invLength = _mm256_div_ps(one , _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(world[0] , world[0])
+                    , _mm256_mul_ps(world[1] , world[1])) , _mm256_mul_ps(world[2] , world[2]))));
+                for(int row = 0; row < 3; ++row)
+                {
+                    _mm256_storeu_ps(outputs[stream][row] , _mm256_mul_ps(world[row] , invLength));
+                }
+            }
+        }
+    }
+}
+
+namespace software
+{
+    /// @brief the range of every vertex of a mesh, for transforming it whole
+    /// @param objectStreams the object space streams of the mesh
+    /// @return the range from the first vertex, over vertexCount vertices
+    VertexRange GetWholeVertexRange(const ObjectVertexStreams& objectStreams) noexcept
+    {
+        return VertexRange{0 , static_cast<uint32_t>(objectStreams.vertexCount)};
+    }
+
+    /// @brief the software vertex stage, transforms the object streams of a mesh in batches of 4 or 8 vertices
+    /// @param objectStreams the object space streams of the mesh
+    /// @param transformedStreams output, the streams get allocated in the frame arena unless they already hold this mesh
+    /// @param frameArena the arena of the current frame
+    /// @param worldMatrix the world matrix of the primitive
+    /// @param worldViewProjectionMatrix projection * view * world
+    /// @param cameraPosition position of the camera in world space, for the view direction
+    /// @param simdLevel the widest instruction set to use
+    /// @param ranges the vertices to transform, starting at a multiple of 8, empty transforms nothing, GetWholeVertexRange for all of them
+    void TransformVertexStreams(const ObjectVertexStreams& objectStreams , TransformedVertexStreams& transformedStreams
+        , FrameArena& frameArena , const Elite::FMatrix4& worldMatrix , const Elite::FMatrix4& worldViewProjectionMatrix
+        , const Elite::FPoint3& cameraPosition , SimdLevel simdLevel , std::span<const VertexRange> ranges)
+    {
+        const size_t paddedCount = GetPaddedVertexCount(objectStreams.vertexCount);
+
+        //the instances of a mesh overwrite the streams of the previous instance
+        if(transformedStreams.pObjectStreams != &objectStreams)
+        {
+            for(float** ppStream : {&transformedStreams.positionX , &transformedStreams.positionY , &transformedStreams.positionZ
+                , &transformedStreams.positionW , &transformedStreams.normalX , &transformedStreams.normalY , &transformedStreams.normalZ
+                , &transformedStreams.tangentX , &transformedStreams.tangentY , &transformedStreams.tangentZ
+                , &transformedStreams.viewDirectionX , &transformedStreams.viewDirectionY , &transformedStreams.viewDirectionZ})
+            {
+                *ppStream = frameArena.AllocateArray<float>(paddedCount).data();
+            }
+        }
+        transformedStreams.vertexCount = objectStreams.vertexCount;
+        transformedStreams.pObjectStreams = &objectStreams;
+
+        VertexStageMatrices matrices;
+        for(int r = 0; r < 4; ++r)
+        {
+            for(int c = 0; c < 4; ++c)
+            {
+                matrices.world[r * 4 + c] = worldMatrix(r , c);
+                matrices.worldViewProjection[r * 4 + c] = worldViewProjectionMatrix(r , c);
+            }
+        }
+        matrices.cameraPosition[0] = cameraPosition.x;
+        matrices.cameraPosition[1] = cameraPosition.y;
+        matrices.cameraPosition[2] = cameraPosition.z;
+
+        for(const VertexRange& range : ranges)
+        {
+            const size_t first = range.first;
+            const size_t paddedLast = first + GetPaddedVertexCount(range.count);
+
+            switch(simdLevel)
+            {
+                case SimdLevel::AVX2:
+                    TransformAVX2(objectStreams , transformedStreams , matrices , first , paddedLast);
+                    break;
+                case SimdLevel::SSE:
+                    TransformSSE(objectStreams , transformedStreams , matrices , first , paddedLast);
+                    break;
+                case SimdLevel::Scalar:
+                    TransformScalar(objectStreams , transformedStreams , matrices , first , first + range.count);
+                    break;
+                default:
+                    TransformScalar(objectStreams , transformedStreams , matrices , first , first + range.count);
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+// - Standard includes -
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+// - Project includes -
+#include "EMath.h"
+#include "EdgeFunctions.h"
+#include "FrameArena.h"
+#include "SoftwareRasterTypes.h"
+
+namespace software
+{
+    /// @brief the vertex buffer of a mesh in object space, one stream per component
+    /// @brief built once per mesh, the size is padded to a multiple of 8 so the batches don't need a tail
+    struct ObjectVertexStreams
+    {
+        size_t vertexCount{};
+        std::vector<float> positionX , positionY , positionZ;
+        std::vector<float> normalX , normalY , normalZ;
+        std::vector<float> tangentX , tangentY , tangentZ;
+        std::vector<float> u , v;
+    };
+
+    /// @brief the output of the vertex stage for one primitive, the streams live in the frame arena
+    /// @brief positions are in homogeneous clip space, normals and tangents in world space
+    /// @brief the uv's don't change in the vertex stage and are read from the object streams
+    struct TransformedVertexStreams
+    {
+        size_t vertexCount{};
+        float* positionX{} , * positionY{} , * positionZ{} , * positionW{};
+        float* normalX{} , * normalY{} , * normalZ{};
+        float* tangentX{} , * tangentY{} , * tangentZ{};
+        float* viewDirectionX{} , * viewDirectionY{} , * viewDirectionZ{};
+        const ObjectVertexStreams* pObjectStreams{};
+
+        Elite::FPoint4 GetPosition(uint32_t index) const noexcept;
+    };
+
+    /// @brief amount of vertices in the widest batch, the streams are padded to a multiple of it
+    constexpr size_t VertexBatchSize{8};
+
+    /// @brief a part of the vertex streams, the vertices of one meshlet
+    struct VertexRange
+    {
+        uint32_t first; //multiple of VertexBatchSize
+        uint32_t count;
+    };
+
+    VertexRange GetWholeVertexRange(const ObjectVertexStreams& objectStreams) noexcept;
+
+    template<typename VertexType>
+    void BuildObjectVertexStreams(std::span<const VertexType> vertexBuffer , ObjectVertexStreams& objectStreams);
+    template<typename VertexType>
+    void BuildObjectVertexStreams(const std::vector<VertexType>& vertexBuffer , ObjectVertexStreams& objectStreams);
+
+    void TransformVertexStreams(const ObjectVertexStreams& objectStreams , TransformedVertexStreams& transformedStreams
+        , FrameArena& frameArena , const Elite::FMatrix4& worldMatrix , const Elite::FMatrix4& worldViewProjectionMatrix
+        , const Elite::FPoint3& cameraPosition , SimdLevel simdLevel , std::span<const VertexRange> ranges);
+
+    ClipVertex GatherClipVertex(const TransformedVertexStreams& streams , uint32_t index) noexcept;
+
+    // =============================================================================
+    //                               Inline Definitions
+    // =============================================================================
+
+    /// @brief round up to a whole amount of batches
+    inline size_t GetPaddedVertexCount(size_t count) noexcept
+    {
+        return (count + VertexBatchSize - 1) / VertexBatchSize * VertexBatchSize;
+    }
+
+    /// @brief split the vertex buffer of a mesh into object space streams, only needed once per mesh
+    /// @param vertexBuffer the vertex buffer of the mesh, any vertex with a position, normal, tangent and uv, also a view into a mesh cache
+    /// @param objectStreams output
+    template<typename VertexType>
+    void BuildObjectVertexStreams(std::span<const VertexType> vertexBuffer , ObjectVertexStreams& objectStreams)
+    {
+        const size_t paddedCount = GetPaddedVertexCount(vertexBuffer.size());
+
+        objectStreams.vertexCount = vertexBuffer.size();
+        for(std::vector<float>* pStream : {&objectStreams.positionX , &objectStreams.positionY , &objectStreams.positionZ
+            , &objectStreams.normalX , &objectStreams.normalY , &objectStreams.normalZ
+            , &objectStreams.tangentX , &objectStreams.tangentY , &objectStreams.tangentZ , &objectStreams.u , &objectStreams.v})
+        {
+            pStream->assign(paddedCount , 0.0f);
+        }
+
+        for(size_t i = 0; i < paddedCount; ++i)
+        {
+            //padding lanes get a valid normal, tangent and depth so they don't divide by 0
+            if(i >= vertexBuffer.size())
+            {
+                objectStreams.normalZ[i] = 1.0f;
+                objectStreams.tangentX[i] = 1.0f;
+                objectStreams.positionZ[i] = 1.0f;
+                continue;
+            }
+
+            const VertexType& vertex = vertexBuffer[i];
+            objectStreams.positionX[i] = vertex.position.x;
+            objectStreams.positionY[i] = vertex.position.y;
+            objectStreams.positionZ[i] = vertex.position.z;
+            objectStreams.normalX[i] = vertex.normal.x;
+            objectStreams.normalY[i] = vertex.normal.y;
+            objectStreams.normalZ[i] = vertex.normal.z;
+            objectStreams.tangentX[i] = vertex.tangent.x;
+            objectStreams.tangentY[i] = vertex.tangent.y;
+            objectStreams.tangentZ[i] = vertex.tangent.z;
+            objectStreams.u[i] = vertex.uv.x;
+            objectStreams.v[i] = vertex.uv.y;
+        }
+    }
+
+    template<typename VertexType>
+    void BuildObjectVertexStreams(const std::vector<VertexType>& vertexBuffer , ObjectVertexStreams& objectStreams)
+    {
+        BuildObjectVertexStreams(std::span<const VertexType>{vertexBuffer} , objectStreams);
+    }
+
+    /// @brief gather the clip space position and the attributes of one vertex for triangle setup
+    /// @param streams the transformed streams of the primitive
+    /// @param index the index of the vertex
+    /// @return the vertex, attributes in the order of VertexAttribute
+    inline ClipVertex GatherClipVertex(const TransformedVertexStreams& streams , uint32_t index) noexcept
+    {
+        const ObjectVertexStreams& objectStreams = *streams.pObjectStreams;
+        return ClipVertex
+        {
+            streams.GetPosition(index),
+            {
+                objectStreams.u[index] , objectStreams.v[index],
+                streams.normalX[index] , streams.normalY[index] , streams.normalZ[index],
+                streams.tangentX[index] , streams.tangentY[index] , streams.tangentZ[index],
+                streams.viewDirectionX[index] , streams.viewDirectionY[index] , streams.viewDirectionZ[index]
+            }
+        };
+    }
+
+    /// @brief gather the position of one vertex
+    inline Elite::FPoint4 TransformedVertexStreams::GetPosition(uint32_t index) const noexcept
+    {
+        return Elite::FPoint4{positionX[index] , positionY[index] , positionZ[index] , positionW[index]};
+    }
+}
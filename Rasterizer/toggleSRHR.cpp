@@ -4,9 +4,19 @@ std::function<void()> hardwareRender = [&pRenderer] { pRenderer->RenderHardware(
 std::function<void()> softwareRender = [&pRenderer] { pRenderer->RenderSoftware(); };
 GameManager::GetInstance()->Initialize(hardwareRender , softwareRender);
 
+//the software renderer draws a snapshot on its own thread while the next frame updates, presenting stays on this thread
+GameManager::GetInstance()->InitializeFramePipeline([&pRenderer](const FrameSnapshot& snapshot) { pRenderer->RenderSoftware(snapshot); }
+    , [&pRenderer] { pRenderer->BeginSoftwarePresent(); } , [&pRenderer] { pRenderer->PresentSoftware(); });
+
+//in the frame loop, instead of updating and then rendering
+GameManager::GetInstance()->UpdateAndRender(deltaTime , [](float deltaTime)
+{
+    CameraManager::GetInstance()->GetCamera()->Update(deltaTime);
+    SceneManager::GetInstance()->Update(deltaTime);
+});
+
 GameManager::GameManager()
     : m_RenderMode{RenderMode::hardware}
-    , m_FrustumCullingMode{FrustumCullingMode::OneVertexMode}
     , m_Gammavalue{0.9f}
 {}
 
@@ -21,9 +31,33 @@ void GameManager::Render()
     m_pCurrentRenderFunction();
 }
 
+/// @brief update the frame and render it, pipelined in software mode once a frame pipeline is set up
+/// @brief pipelined, the render of the last update runs next to this update, so what is shown lags a frame behind
+/// @param deltaTime the elapsed time since the previous frame
+/// @param updateScene moves the camera and the primitives of the scene
+void GameManager::UpdateAndRender(float deltaTime , const std::function<void(float)>& updateScene)
+{
+    if(m_RenderMode == RenderMode::software && m_pFramePipeline)
+    {
+        m_pFramePipeline->RunFrame([this , deltaTime , &updateScene]
+        {
+            updateScene(deltaTime);
+            Update(deltaTime);
+        });
+        return;
+    }
+
+    updateScene(deltaTime);
+    Update(deltaTime);
+    Render();
+}
+
 /// @brief switch to the next render state
 void GameManager::SwitchRenderFunction()
 {
+    //the waiting snapshot was captured with the camera conventions of the other renderer
+    if(m_pFramePipeline) m_pFramePipeline->Reset();
+
     if(m_RenderMode == RenderMode::software)
     {
         m_pCurrentRenderFunction = m_pHardwareRenderFunction;
@@ -40,6 +74,13 @@ void GameManager::SwitchRenderFunction()
 
 }
 
+/// @brief get the gamma of the display, the software renderer applies it when it resolves its linear color buffer
+/// @return the gamma value
+float GameManager::GetGammaValue() const noexcept
+{
+    return m_Gammavalue;
+}
+
 /// @brief initialize the function pointers to the different render functions
 /// @param hardwareRender function pointer to the hardware renderer
 /// @param softwareRender function pointer to the software renderer
@@ -48,4 +89,14 @@ void GameManager::Initialize(const std::function<void()>& hardwareRender , const
     m_pHardwareRenderFunction = hardwareRender;
     m_pSoftwareRenderFunction = softwareRender;
     m_pCurrentRenderFunction = hardwareRender;
-}
\ No newline at end of file
+}
+
+/// @brief start the render thread of the pipelined software frame loop, UpdateAndRender uses it from then on
+/// @param softwareSnapshotRender renders a snapshot with the software renderer, up to the resolve
+/// @param softwareBeginPresent picks and locks the surface the snapshot render resolves into, on the thread of the window
+/// @param softwarePresent shows the resolved frame, on the thread of the window
+void GameManager::InitializeFramePipeline(const std::function<void(const FrameSnapshot&)>& softwareSnapshotRender
+    , const std::function<void()>& softwareBeginPresent , const std::function<void()>& softwarePresent)
+{
+    m_pFramePipeline = std::make_unique<FramePipeline>(softwareSnapshotRender , softwareBeginPresent , softwarePresent);
+}